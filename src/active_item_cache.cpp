@@ -33,13 +33,18 @@ bool active_item_cache::empty() const
 // It relies on the processing logic to remove and reinsert the items to they
 // move to the back of their respective lists (or to new lists).
 // Otherwise only the first n items will ever be processed.
-std::list<item_reference> active_item_cache::get()
+std::vector<item_reference> active_item_cache::get() const
 {
-    std::list<item_reference> items_to_process;
+    size_t total = 0;
+    for( auto &tuple : active_items ) {
+        total += tuple.second.size();
+    }
+    std::vector<item_reference> items_to_process;
+    items_to_process.reserve( total );
     for( auto &tuple : active_items ) {
         // Rely on iteration logic to make sure the number is sane.
         int num_to_process = tuple.second.size() / tuple.first;
-        for( auto &an_iter : tuple.second ) {
+        for( const auto &an_iter : tuple.second ) {
             items_to_process.push_back( an_iter );
             if( --num_to_process < 0 ) {
                 break;
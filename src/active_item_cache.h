@@ -6,6 +6,7 @@
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // A struct used to uniquely identify an item within a submap or vehicle.
 struct item_reference {
@@ -29,7 +30,8 @@ class active_item_cache
         // Use this one if there's a chance that the item being referenced has been invalidated.
         bool has( item_reference const &itm ) const;
         bool empty() const;
-        std::list<item_reference> get();
+        // Processing adds and removes items, so this is a snapshot of the items to process now.
+        std::vector<item_reference> get() const;
 };
 
 #endif
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <stdlib.h>     /* srand, rand */
 #include <sstream>
 
@@ -64,6 +65,9 @@ static const std::string TILE_CATEGORY_IDS[] = {
     "hit_entity", // C_HIT_ENTITY,
     "weather", // C_WEATHER,
 };
+static const std::string season_suffix[4] = {
+    "_season_spring", "_season_summer", "_season_autumn", "_season_winter"
+};
 
 void SDL_Texture_deleter::operator()( SDL_Texture *const ptr )
 {
@@ -120,6 +124,7 @@ void cata_tiles::clear()
     night_tile_values.clear();
     overexposed_tile_values.clear();
     tile_ids.clear();
+    invalidate_tile_lookups();
     // release minimap
     minimap_cache.clear();
     tex_pool.texture_pool.clear();
@@ -858,6 +863,9 @@ void cata_tiles::draw( int destx, int desty, const tripoint &center, int width,
     if (!g) {
         return;
     }
+    if( !tile_lookups_valid ) {
+        build_tile_lookups();
+    }
 
     {
         //set clipping to prevent drawing over stuff we shouldn't
@@ -1405,6 +1413,99 @@ void cata_tiles::get_window_tile_counts(const int width, const int height, int &
     rows = ( tile_iso && use_tiles ) ? ceil((double) height / ( tile_width / 2 - 1 ) ) * 2 + 4 : ceil((double) height / tile_height);
 }
 
+bool cata_tiles::outside_drawing_area( const tripoint &pos ) const
+{
+    return !( tile_iso && use_tiles ) &&
+           ( pos.x - o_x < 0 || pos.x - o_x >= screentile_width ||
+             pos.y - o_y < 0 || pos.y - o_y >= screentile_height );
+}
+
+void cata_tiles::invalidate_tile_lookups()
+{
+    tile_lookups_valid = false;
+}
+
+const cata_tiles::tile_id_entry *cata_tiles::find_seasonal_tile( const std::string &id,
+        int season ) const
+{
+    auto it = tile_ids.find( id + season_suffix[season] );
+    if( it == tile_ids.end() ) {
+        it = tile_ids.find( id );
+    }
+    return it == tile_ids.end() ? nullptr : &*it;
+}
+
+cata_tiles::resolved_tile cata_tiles::resolve_tile( const std::string &id, int season ) const
+{
+    resolved_tile result;
+    result.tile = find_seasonal_tile( id, season );
+    if( result.tile == nullptr || !result.tile->second.multitile ) {
+        return result;
+    }
+    const auto &available = result.tile->second.available_subtiles;
+    for( int i = 0; i < num_multitile_types; i++ ) {
+        if( std::find( available.begin(), available.end(), multitile_keys[i] ) != available.end() ) {
+            // The same id that draw_found_tile looks up by string.
+            result.subtiles[i] = find_seasonal_tile( id + "_" + multitile_keys[i], season );
+        }
+    }
+    return result;
+}
+
+void cata_tiles::build_tile_lookups()
+{
+    const auto fill = [this]( tile_lookup & lookup, size_t count,
+    const std::function<const std::string &( size_t )> &get_id ) {
+        for( int season = 0; season < 4; season++ ) {
+            auto &tiles = lookup[season];
+            tiles.clear();
+            tiles.reserve( count );
+            for( size_t i = 0; i < count; i++ ) {
+                tiles.push_back( resolve_tile( get_id( i ), season ) );
+            }
+        }
+    };
+    fill( terrain_tiles, ter_t::count(), []( size_t i ) -> const std::string & {
+        return ter_id( i ).obj().id.str();
+    } );
+    fill( furniture_tiles, furn_t::count(), []( size_t i ) -> const std::string & {
+        return furn_id( i ).obj().id;
+    } );
+    fill( trap_tiles, trap::count(), []( size_t i ) -> const std::string & {
+        return trap_id( i ).obj().id.str();
+    } );
+    fill( field_tiles, num_fields, []( size_t i ) -> const std::string & {
+        return fieldlist[i].id;
+    } );
+    tile_lookups_valid = true;
+}
+
+bool cata_tiles::draw_from_lookup( const tile_lookup &lookup, size_t id, const std::string &str_id,
+                                   TILE_CATEGORY category, const tripoint &pos, int subtile,
+                                   int rota, lit_level ll, bool apply_night_vision_goggles,
+                                   int &height_3d )
+{
+    if( outside_drawing_area( pos ) ) {
+        return false;
+    }
+    const auto &tiles = lookup[calendar::turn.get_season()];
+    if( id >= tiles.size() || tiles[id].tile == nullptr ) {
+        // No tile of its own, the string lookup knows about the fallbacks.
+        return draw_from_id_string( str_id, category, empty_string, pos, subtile, rota, ll,
+                                    apply_night_vision_goggles, height_3d );
+    }
+    const resolved_tile &resolved = tiles[id];
+    if( subtile != -1 && resolved.tile->second.multitile && resolved.subtiles[subtile] != nullptr ) {
+        // Drawn like draw_found_tile draws the subtile it looks up by string.
+        const tile_id_entry &sub = *resolved.subtiles[subtile];
+        return draw_found_tile( sub.first, C_NONE, sub.second, pos, -1, rota, ll,
+                                apply_night_vision_goggles, height_3d );
+    }
+    // Subtiles the tileset does not define go through the string lookup in draw_found_tile.
+    return draw_found_tile( str_id, category, resolved.tile->second, pos, subtile, rota, ll,
+                            apply_night_vision_goggles, height_3d );
+}
+
 bool cata_tiles::draw_from_id_string( std::string id, tripoint pos, int subtile, int rota,
                                       lit_level ll, bool apply_night_vision_goggles )
 {
@@ -1442,17 +1543,10 @@ bool cata_tiles::draw_from_id_string(std::string id, TILE_CATEGORY category,
     // check to make sure that we are drawing within a valid area
     // [0->width|height / tile_width|height]
 
-    if( !( tile_iso && use_tiles ) &&
-        ( pos.x - o_x < 0 || pos.x - o_x >= screentile_width ||
-          pos.y - o_y < 0 || pos.y - o_y >= screentile_height ) ) {
+    if( outside_drawing_area( pos ) ) {
         return false;
     }
 
-
-    constexpr size_t suffix_len = 15;
-    constexpr char season_suffix[4][suffix_len] = {
-        "_season_spring", "_season_summer", "_season_autumn", "_season_winter"};
-
     std::string seasonal_id = id + season_suffix[calendar::turn.get_season()];
 
     auto it = tile_ids.find(seasonal_id);
@@ -1585,16 +1679,23 @@ bool cata_tiles::draw_from_id_string(std::string id, TILE_CATEGORY category,
         return false;
     }
 
-    tile_type &display_tile = it->second;
+    return draw_found_tile( id, category, it->second, pos, subtile, rota, ll,
+                            apply_night_vision_goggles, height_3d );
+}
+
+bool cata_tiles::draw_found_tile( const std::string &id, TILE_CATEGORY category,
+                                  const tile_type &display_tile, const tripoint &pos, int subtile,
+                                  int rota, lit_level ll, bool apply_night_vision_goggles,
+                                  int &height_3d )
+{
     // check to see if the display_tile is multitile, and if so if it has the key related to subtile
     if (subtile != -1 && display_tile.multitile) {
         auto const &display_subtiles = display_tile.available_subtiles;
         auto const end = std::end(display_subtiles);
         if (std::find(begin(display_subtiles), end, multitile_keys[subtile]) != end) {
             // append subtile name to tile and re-find display_tile
-            return draw_from_id_string(
-                std::move( id.append( "_", 1 ).append( multitile_keys[subtile] ) ),
-                pos, -1, rota, ll, apply_night_vision_goggles, height_3d );
+            return draw_from_id_string( id + "_" + multitile_keys[subtile],
+                                        pos, -1, rota, ll, apply_night_vision_goggles, height_3d );
         }
     }
 
@@ -1931,10 +2032,8 @@ bool cata_tiles::draw_terrain( const tripoint &p, lit_level ll, int &height_3d )
         // do something to get other terrain orientation values
     }
 
-    const std::string& tname = t.obj().id.str();
-
-    return draw_from_id_string( tname, C_TERRAIN, empty_string, p, subtile, rotation, ll,
-                                nv_goggles_activated, height_3d );
+    return draw_from_lookup( terrain_tiles, t.to_i(), t.obj().id.str(), C_TERRAIN, p, subtile,
+                             rotation, ll, nv_goggles_activated, height_3d );
 }
 
 bool cata_tiles::draw_furniture( const tripoint &p, lit_level ll, int &height_3d )
@@ -1958,10 +2057,8 @@ bool cata_tiles::draw_furniture( const tripoint &p, lit_level ll, int &height_3d
     int subtile = 0, rotation = 0;
     get_tile_values(f_id, neighborhood, subtile, rotation);
 
-    // get the name of this furniture piece
-    const std::string& f_name = f_id.obj().id; // replace with furniture names array access
-    bool ret = draw_from_id_string( f_name, C_FURNITURE, empty_string, p, subtile, rotation, ll,
-                                    nv_goggles_activated, height_3d );
+    bool ret = draw_from_lookup( furniture_tiles, f_id.to_i(), f_id.obj().id, C_FURNITURE, p,
+                                 subtile, rotation, ll, nv_goggles_activated, height_3d );
     if( ret && g->m.sees_some_items( p, g->u ) ) {
         draw_item_highlight( p );
     }
@@ -1985,8 +2082,8 @@ bool cata_tiles::draw_trap( const tripoint &p, lit_level ll, int &height_3d )
     int subtile = 0, rotation = 0;
     get_tile_values(tr.loadid, neighborhood, subtile, rotation);
 
-    return draw_from_id_string( tr.id.str(), C_TRAP, empty_string, p, subtile, rotation, ll,
-                               nv_goggles_activated, height_3d );
+    return draw_from_lookup( trap_tiles, tr.loadid.to_i(), tr.id.str(), C_TRAP, p, subtile,
+                             rotation, ll, nv_goggles_activated, height_3d );
 }
 
 bool cata_tiles::draw_field_or_item( const tripoint &p, lit_level ll, int &height_3d )
@@ -2037,8 +2134,6 @@ bool cata_tiles::draw_field_or_item( const tripoint &p, lit_level ll, int &heigh
     bool ret_draw_field = true;
     bool ret_draw_item = true;
     if (is_draw_field) {
-        const std::string fd_name = fieldlist[f.fieldSymbol()].id;
-
         // for rotation inforomation
         const int neighborhood[4] = {
             static_cast<int> (g->m.field_at( tripoint( p.x, p.y + 1, p.z ) ).fieldSymbol()), // south
@@ -2050,8 +2145,9 @@ bool cata_tiles::draw_field_or_item( const tripoint &p, lit_level ll, int &heigh
         int subtile = 0, rotation = 0;
         get_tile_values(f.fieldSymbol(), neighborhood, subtile, rotation);
 
-        ret_draw_field = draw_from_id_string( fd_name, C_FIELD, empty_string, p, subtile, rotation,
-                                              ll, nv_goggles_activated );
+        int nullint = 0;
+        ret_draw_field = draw_from_lookup( field_tiles, f_id, fieldlist[f_id].id, C_FIELD, p,
+                                           subtile, rotation, ll, nv_goggles_activated, nullint );
     }
     if(do_item) {
         if( !g->m.sees_some_items( p, g->u ) ) {
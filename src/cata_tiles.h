@@ -11,6 +11,7 @@
 #include "enums.h"
 #include "weighted_list.h"
 
+#include <array>
 #include <list>
 #include <map>
 #include <vector>
@@ -328,6 +329,44 @@ class cata_tiles
         /** How many rows and columns of tiles fit into given dimensions **/
         void get_window_tile_counts( const int width, const int height, int &columns, int &rows ) const;
 
+        /** An entry of @ref tile_ids, the id is the seasonal one if the tileset has it. */
+        using tile_id_entry = std::unordered_map<std::string, tile_type>::value_type;
+        /** The tiles of one game object for one season. */
+        struct resolved_tile {
+            /** nullptr if there is no tile with the id of the object. */
+            const tile_id_entry *tile = nullptr;
+            /**
+             * The tiles of the subtiles (indexed by @ref MULTITILE_TYPE) that a multitile lists.
+             * nullptr if the tile does not list the subtile or the tileset does not define it.
+             */
+            std::array<const tile_id_entry *, num_multitile_types> subtiles = {{}};
+        };
+        /**
+         * Tiles of one kind of game object (e.g. terrain), indexed by season and then by the
+         * int id of the object.
+         */
+        using tile_lookup = std::array<std::vector<resolved_tile>, 4>;
+
+        bool outside_drawing_area( const tripoint &pos ) const;
+        /** Finds the tile for the given season, or the tile without season. */
+        const tile_id_entry *find_seasonal_tile( const std::string &id, int season ) const;
+        /** Finds the tile and the subtiles of the object with the given id. */
+        resolved_tile resolve_tile( const std::string &id, int season ) const;
+        /** Resolves the tiles of all terrain, furniture, traps and fields into the lookups. */
+        void build_tile_lookups();
+        /**
+         * Draws the object with the given int id using the lookup, without any string work.
+         * Objects without a tile of their own go through @ref draw_from_id_string with str_id,
+         * and so do subtiles that the tileset lists but does not define.
+         */
+        bool draw_from_lookup( const tile_lookup &lookup, size_t id, const std::string &str_id,
+                               TILE_CATEGORY category, const tripoint &pos, int subtile, int rota,
+                               lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+        /** Draws a tile that has already been looked up, id is the key of it in @ref tile_ids. */
+        bool draw_found_tile( const std::string &id, TILE_CATEGORY category,
+                              const tile_type &display_tile, const tripoint &pos, int subtile,
+                              int rota, lit_level ll, bool apply_night_vision_goggles,
+                              int &height_3d );
         bool draw_from_id_string( std::string id, tripoint pos, int subtile, int rota, lit_level ll,
                                   bool apply_night_vision_goggles );
         bool draw_from_id_string( std::string id, TILE_CATEGORY category,
@@ -439,6 +478,11 @@ class cata_tiles
         void reinit();
 
         void reinit_minimap();
+        /**
+         * Drops the tiles that have been resolved for int ids, this must be called whenever
+         * the game data (and with it the int ids) changes.
+         */
+        void invalidate_tile_lookups();
 
         int get_tile_height() const {
             return tile_height;
@@ -478,6 +522,11 @@ class cata_tiles
         SDL_Renderer *renderer;
         std::vector<SDL_Texture_Ptr> tile_values;
         std::unordered_map<std::string, tile_type> tile_ids;
+        tile_lookup terrain_tiles;
+        tile_lookup furniture_tiles;
+        tile_lookup trap_tiles;
+        tile_lookup field_tiles;
+        bool tile_lookups_valid = false;
 
         int tile_height = 0, tile_width = 0, default_tile_width, default_tile_height;
         // The width and height of the area we can draw in,
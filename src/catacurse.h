@@ -11,6 +11,7 @@
 #include <array>
 #include <string>
 #include <cstdint>
+#include <cstring>
 
 typedef int chtype;
 typedef unsigned short attr_t;
@@ -29,14 +30,71 @@ typedef struct {
 // pairs color;//pair of foreground/background, indexed into colors[]
 //} cursechar;
 
+/**
+ * The text of a single cell: one character, possibly followed by combining characters,
+ * encoded as UTF-8. It's stored inline, so cells can be copied and compared without
+ * touching the heap. Longer sequences are cut at a character boundary.
+ * Empty for the second cell of a wide character.
+ */
+class cursecell_text
+{
+    public:
+        static constexpr size_t capacity = 14;
+
+        cursecell_text() = default;
+        cursecell_text( const char *str ) {
+            assign( str, strlen( str ) );
+        }
+
+        void assign( const char *str, size_t n ) {
+            if( n > capacity ) {
+                n = capacity;
+                // Don't cut a multi-byte character in half.
+                while( n > 0 && ( static_cast<unsigned char>( str[n] ) & 0xC0 ) == 0x80 ) {
+                    n--;
+                }
+            }
+            memcpy( data, str, n );
+            data[n] = '\0';
+            len = n;
+        }
+        void clear() {
+            assign( "", 0 );
+        }
+
+        bool empty() const {
+            return len == 0;
+        }
+        size_t length() const {
+            return len;
+        }
+        const char *c_str() const {
+            return data;
+        }
+        char operator[]( size_t i ) const {
+            return data[i];
+        }
+        std::string str() const {
+            return std::string( data, len );
+        }
+
+        bool operator==( const cursecell_text &rhs ) const {
+            return len == rhs.len && memcmp( data, rhs.data, len ) == 0;
+        }
+
+    private:
+        unsigned char len = 0;
+        char data[capacity + 1] = {};
+};
+
 //Individual lines, so that we can track changed lines
 struct cursecell {
-    std::string ch;
+    cursecell_text ch;
     char FG = 0;
     char BG = 0;
 
-    cursecell( std::string ch ) : ch( std::move( ch ) ) { }
-    cursecell() : cursecell( std::string( 1, ' ' ) ) { }
+    cursecell( const char *ch ) : ch( ch ) { }
+    cursecell() : cursecell( " " ) { }
 
     bool operator==( const cursecell &b ) const {
         return FG == b.FG && BG == b.BG && ch == b.ch;
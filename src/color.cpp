@@ -150,7 +150,7 @@ nc_color color_manager::get_invert( const nc_color col ) const
 nc_color color_manager::get_random() const
 {
     auto item = color_array.begin();
-    std::advance( item, rand() % num_colors );
+    std::advance( item, rng( 0, num_colors - 1 ) );
 
     return item->color;
 }
@@ -4,6 +4,12 @@
 #include "debug.h"
 #include "mtype.h"
 #include "item.h"
+#include "line.h"
+#include "coordinate_conversions.h"
+#include "game_constants.h"
+
+#include <algorithm>
+#include <climits>
 
 Creature_tracker::Creature_tracker()
 {
@@ -76,6 +82,7 @@ bool Creature_tracker::add( monster &critter )
 
     monsters_by_location[critter.pos()] = monsters_list.size();
     monsters_list.push_back( new monster( critter ) );
+    add_to_submap_map( *monsters_list.back(), critter.pos() );
     return true;
 }
 
@@ -91,6 +98,10 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         // mon_at ignores dead critters anyway, changing their position in the
         // monsters_by_location map is useless.
         remove_from_location_map( critter );
+        monster *const ptr = remove_from_submap_map( critter, old_pos );
+        if( ptr != nullptr ) {
+            add_to_submap_map( *ptr, new_pos );
+        }
         return true;
     }
 
@@ -112,6 +123,10 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         if( &critter == monsters_list[critter_id] ) {
             monsters_by_location.erase( old_pos );
             monsters_by_location[new_pos] = critter_id;
+            if( ms_to_sm_copy( old_pos ) != ms_to_sm_copy( new_pos ) ) {
+                remove_from_submap_map( critter, old_pos );
+                add_to_submap_map( *monsters_list[critter_id], new_pos );
+            }
             return true;
         } else {
             const auto &othermon = *monsters_list[critter_id];
@@ -146,6 +161,44 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
     }
 }
 
+void Creature_tracker::add_to_submap_map( monster &critter, const tripoint &pos )
+{
+    monsters_by_submap[ms_to_sm_copy( pos )].push_back( &critter );
+}
+
+monster *Creature_tracker::remove_from_submap_map( const monster &critter, const tripoint &pos )
+{
+    const auto take_from = [&critter, this]( decltype( monsters_by_submap )::iterator iter ) {
+        auto &bucket = iter->second;
+        const auto found = std::find( bucket.begin(), bucket.end(), &critter );
+        if( found == bucket.end() ) {
+            return static_cast<monster *>( nullptr );
+        }
+        monster *const result = *found;
+        bucket.erase( found );
+        if( bucket.empty() ) {
+            monsters_by_submap.erase( iter );
+        }
+        return result;
+    };
+
+    const auto sm_iter = monsters_by_submap.find( ms_to_sm_copy( pos ) );
+    if( sm_iter != monsters_by_submap.end() ) {
+        monster *const result = take_from( sm_iter );
+        if( result != nullptr ) {
+            return result;
+        }
+    }
+    // The position changed without us being told (e.g. map shifting), search everywhere.
+    for( auto iter = monsters_by_submap.begin(); iter != monsters_by_submap.end(); ++iter ) {
+        monster *const result = take_from( iter );
+        if( result != nullptr ) {
+            return result;
+        }
+    }
+    return nullptr;
+}
+
 void Creature_tracker::remove( const int idx )
 {
     if( idx < 0 || idx >= ( int )monsters_list.size() ) {
@@ -156,6 +209,7 @@ void Creature_tracker::remove( const int idx )
 
     monster &m = *monsters_list[idx];
     remove_from_location_map( m );
+    remove_from_submap_map( m, m.pos() );
 
     delete monsters_list[idx];
     monsters_list.erase( monsters_list.begin() + idx );
@@ -175,14 +229,17 @@ void Creature_tracker::clear()
     }
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_submap.clear();
 }
 
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     for( size_t i = 0; i < monsters_list.size(); i++ ) {
         monster &critter = *monsters_list[i];
         monsters_by_location[critter.pos()] = i;
+        add_to_submap_map( critter, critter.pos() );
     }
 }
 
@@ -202,6 +259,8 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     const int second_mdex = mon_at( second.pos() );
     remove_from_location_map( first );
     remove_from_location_map( second );
+    remove_from_submap_map( first, first.pos() );
+    remove_from_submap_map( second, second.pos() );
     bool ok = true;
     if( first_mdex == -1 || second_mdex == -1 || first_mdex == second_mdex ) {
         debugmsg( "Tried to swap monsters with invalid positions" );
@@ -211,6 +270,8 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     tripoint temp = second.pos();
     second.spawn( first.pos() );
     first.spawn( temp );
+    add_to_submap_map( first, first.pos() );
+    add_to_submap_map( second, second.pos() );
     if( ok ) {
         monsters_by_location[first.pos()] = first_mdex;
         monsters_by_location[second.pos()] = second_mdex;
@@ -219,3 +280,118 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
         rebuild_cache();
     }
 }
+
+void Creature_tracker::for_each_in_radius( const tripoint &center, const int radius,
+        const std::function<void( monster & )> &func ) const
+{
+    if( radius < 0 ) {
+        return;
+    }
+    const int minz = std::max( center.z - radius, -OVERMAP_DEPTH );
+    const int maxz = std::min( center.z + radius, OVERMAP_HEIGHT );
+    const point min_sm = ms_to_sm_copy( center.x - radius, center.y - radius );
+    const point max_sm = ms_to_sm_copy( center.x + radius, center.y + radius );
+    const auto visit = [&]( const std::vector<monster *> &bucket ) {
+        for( monster *critter : bucket ) {
+            if( !critter->is_dead() && rl_dist( center, critter->pos() ) <= radius ) {
+                func( *critter );
+            }
+        }
+    };
+
+    const size_t area = size_t( max_sm.x - min_sm.x + 1 ) * ( max_sm.y - min_sm.y + 1 ) *
+                        ( maxz - minz + 1 );
+    if( area >= monsters_by_submap.size() ) {
+        // Fewer occupied buckets than submaps in the area, checking them all is cheaper.
+        for( const auto &elem : monsters_by_submap ) {
+            const tripoint &sm = elem.first;
+            if( sm.x >= min_sm.x && sm.x <= max_sm.x && sm.y >= min_sm.y && sm.y <= max_sm.y &&
+                sm.z >= minz && sm.z <= maxz ) {
+                visit( elem.second );
+            }
+        }
+        return;
+    }
+
+    tripoint sm;
+    for( sm.z = minz; sm.z <= maxz; sm.z++ ) {
+        for( sm.x = min_sm.x; sm.x <= max_sm.x; sm.x++ ) {
+            for( sm.y = min_sm.y; sm.y <= max_sm.y; sm.y++ ) {
+                const auto iter = monsters_by_submap.find( sm );
+                if( iter != monsters_by_submap.end() ) {
+                    visit( iter->second );
+                }
+            }
+        }
+    }
+}
+
+monster *Creature_tracker::find_nearest( const tripoint &center, const int radius,
+        const std::function<bool( const monster & )> &pred ) const
+{
+    if( radius < 0 ) {
+        return nullptr;
+    }
+    typedef std::pair<int, monster *> candidate;
+    std::vector<candidate> candidates;
+    const auto add = [&center, &candidates]( monster & critter ) {
+        candidates.emplace_back( rl_dist( center, critter.pos() ), &critter );
+    };
+    // Closest first, ties are broken by position, so the bucket order doesn't matter.
+    const auto closer = []( const candidate & a, const candidate & b ) {
+        return a.first < b.first || ( a.first == b.first && a.second->pos() < b.second->pos() );
+    };
+
+    const int minz = std::max( center.z - radius, -OVERMAP_DEPTH );
+    const int maxz = std::min( center.z + radius, OVERMAP_HEIGHT );
+    // Monsters within radius are at most this many submaps away from the submap of center.
+    const int max_ring = ( radius + SEEX - 1 ) / SEEX;
+    const size_t area = size_t( 2 * max_ring + 1 ) * ( 2 * max_ring + 1 ) * ( maxz - minz + 1 );
+    if( area >= monsters_by_submap.size() ) {
+        // Fewer occupied buckets than submaps in the area, sorting all candidates is cheaper.
+        for_each_in_radius( center, radius, add );
+        std::sort( candidates.begin(), candidates.end(), closer );
+        for( const auto &c : candidates ) {
+            if( pred( *c.second ) ) {
+                return c.second;
+            }
+        }
+        return nullptr;
+    }
+
+    const point center_sm = ms_to_sm_copy( center.x, center.y );
+    for( int ring = 0; ring <= max_ring; ring++ ) {
+        tripoint sm;
+        for( sm.z = minz; sm.z <= maxz; sm.z++ ) {
+            for( int dx = -ring; dx <= ring; dx++ ) {
+                // Only the border of the square, the inside belongs to the previous rings.
+                const int dy_step = std::abs( dx ) == ring ? 1 : std::max( 2 * ring, 1 );
+                for( int dy = -ring; dy <= ring; dy += dy_step ) {
+                    sm.x = center_sm.x + dx;
+                    sm.y = center_sm.y + dy;
+                    const auto iter = monsters_by_submap.find( sm );
+                    if( iter == monsters_by_submap.end() ) {
+                        continue;
+                    }
+                    for( monster *critter : iter->second ) {
+                        if( !critter->is_dead() && rl_dist( center, critter->pos() ) <= radius ) {
+                            add( *critter );
+                        }
+                    }
+                }
+            }
+        }
+        std::sort( candidates.begin(), candidates.end(), closer );
+        // Monsters in the following rings are at least this far away (submaps are square),
+        // candidates that are closer can't be beaten by them anymore.
+        const int next_ring_min = ring < max_ring ? ring * SEEX + 1 : INT_MAX;
+        auto iter = candidates.begin();
+        for( ; iter != candidates.end() && iter->first < next_ring_min; ++iter ) {
+            if( pred( *iter->second ) ) {
+                return iter->second;
+            }
+        }
+        candidates.erase( candidates.begin(), iter );
+    }
+    return nullptr;
+}
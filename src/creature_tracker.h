@@ -4,6 +4,7 @@
 #include "enums.h"
 #include <vector>
 #include <unordered_map>
+#include <functional>
 
 class monster;
 
@@ -31,11 +32,40 @@ class Creature_tracker
         /** Swaps the positions of two monsters */
         void swap_positions( monster &first, monster &second );
 
+        /**
+         * Calls func for each living monster within radius (in @ref rl_dist terms) of center.
+         * Only the submap buckets overlapping the area are examined. The order of the calls is
+         * unspecified. func must not add, remove or move monsters.
+         */
+        void for_each_in_radius( const tripoint &center, int radius,
+                                 const std::function<void( monster & )> &func ) const;
+        /**
+         * Returns the living monster closest to center (at most radius away) for which pred
+         * returns true, or nullptr if there is none. Monsters at the same distance are ordered
+         * by position. pred is called in that order and not for any monster after the result.
+         * Buckets are searched in rings of growing distance, unless there are only a few.
+         */
+        monster *find_nearest( const tripoint &center, int radius,
+                               const std::function<bool( const monster & )> &pred ) const;
+
     private:
         std::vector<monster *> monsters_list;
         std::unordered_map<tripoint, size_t> monsters_by_location;
+        /**
+         * All tracked monsters (including dead ones), bucketed by the submap they are on.
+         * Keys are in submap coordinates, see @ref ms_to_sm_copy.
+         */
+        std::unordered_map<tripoint, std::vector<monster *>> monsters_by_submap;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /** Adds the monster to the bucket of the submap containing pos. */
+        void add_to_submap_map( monster &critter, const tripoint &pos );
+        /**
+         * Removes the monster from the bucket of the submap containing pos. Falls back to
+         * searching all buckets if the monster is not found there.
+         * @return The removed entry or nullptr if the monster wasn't in any bucket.
+         */
+        monster *remove_from_submap_map( const monster &critter, const tripoint &pos );
 };
 
 #endif
@@ -347,7 +347,7 @@ int getnstr(char *str, int size)
 
 // Get a sequence of Unicode code points, store them in target
 // return the display width of the extracted string.
-inline int fill(const char *&fmt, int &len, std::string &target)
+inline int fill(const char *&fmt, int &len, cursecell_text &target)
 {
     const char *const start = fmt;
     int dlen = 0; // display width
@@ -378,7 +378,7 @@ inline int fill(const char *&fmt, int &len, std::string &target)
         dlen += cw;
     }
     target.assign(start, fmt - start);
-    len -= target.length();
+    len -= fmt - start;
     return dlen;
 }
 
@@ -414,7 +414,7 @@ inline int printstring(WINDOW *win, const std::string &text)
     }
     if( win->cursorx > 0 && win->line[win->cursory].chars[win->cursorx].ch.empty() ) {
         // start inside a wide character, erase it for good
-        win->line[win->cursory].chars[win->cursorx - 1].ch.assign(" ");
+        win->line[win->cursory].chars[win->cursorx - 1].ch.assign(" ", 1);
     }
     while( len > 0 ) {
         if( *fmt == '\n' ) {
@@ -440,7 +440,7 @@ inline int printstring(WINDOW *win, const std::string &text)
             // following cell ~> clear it
             cursecell *seccell = cur_cell( win );
             if (seccell && seccell->ch.empty()) {
-                seccell->ch.assign(' ', 1);
+                seccell->ch.assign(" ", 1);
             }
         } else if( dlen == 2 ) {
             // the second cell, per definition must be empty
@@ -449,12 +449,12 @@ inline int printstring(WINDOW *win, const std::string &text)
                 // the previous cell was valid, this one is outside of the window
                 // --> the previous was the last cell of the last line
                 // --> there should not be a two-cell width character in the last cell
-                curcell->ch.assign(' ', 1);
+                curcell->ch.assign(" ", 1);
                 return 0;
             }
             seccell->FG = win->FG;
             seccell->BG = win->BG;
-            seccell->ch.erase();
+            seccell->ch.clear();
             addedchar( win );
             // Have just written a wide-character into the last cell, it would not
             // display correctly if it was the last *cell* of a line
@@ -462,12 +462,12 @@ inline int printstring(WINDOW *win, const std::string &text)
                 // So make that last cell a space, move the width
                 // character in the first cell of the line
                 seccell->ch = curcell->ch;
-                curcell->ch.assign(1, ' ');
+                curcell->ch.assign(" ", 1);
                 // and make the second cell on the new line empty.
                 addedchar( win );
                 cursecell *thicell = cur_cell( win );
                 if( thicell != nullptr ) {
-                    thicell->ch.erase();
+                    thicell->ch.clear();
                 }
             }
         }
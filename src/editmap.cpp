@@ -1800,6 +1800,8 @@ int editmap::mapgen_preview( real_coords &tc, uimenu &gmenu )
                                 }
                             }
                             destsm->field_count = srcsm->field_count; // and count
+                            destsm->field_tiles |= srcsm->field_tiles;
+                            std::swap( destsm->item_tiles, srcsm->item_tiles ); // items are swapped below
 
                             std::memcpy( *destsm->ter, srcsm->ter, sizeof( srcsm->ter ) ); // terrain
                             std::memcpy( *destsm->frn, srcsm->frn, sizeof( srcsm->frn ) ); // furniture
@@ -12,7 +12,9 @@
 #include "sounds.h"
 #include "vehicle.h"
 #include "field.h"
+#include "rng.h"
 #include <queue>
+#include <algorithm>
 
 static const itype_id null_itype( "null" );
 
@@ -318,7 +320,7 @@ std::unordered_map<tripoint, std::pair<int, int>> game::explosion( const tripoin
 
             // Truncate to a random selection
             int qty = shr.count * std::min( shr.recovery, 100 ) / 100;
-            std::random_shuffle( tiles.begin(), tiles.end() );
+            std::shuffle( tiles.begin(), tiles.end(), rng_context::current() );
             tiles.resize( std::min( int( tiles.size() ), qty ) );
 
             for( const auto &e : tiles ) {
@@ -15,6 +15,10 @@
 #include "mapdata.h"
 #include "mtype.h"
 
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
 const species_id FUNGUS( "FUNGUS" );
 
 const efftype_id effect_badpoison( "badpoison" );
@@ -367,31 +371,73 @@ field_id field_from_ident(const std::string &field_ident)
 
 bool map::process_fields()
 {
-    bool dirty_transparency_cache = false;
+    // The fields (and their densities) that are not transparent on each tile before
+    // processing. Compared with the result afterwards, so that only the submaps where the
+    // transparency actually changed get their transparency cache dirtied.
+    static std::unordered_map<const submap *, std::array<std::bitset<num_fields * 3>, SEEX * SEEY>>
+            opaque_before;
+    opaque_before.clear();
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
-    bool zlev_dirty;
     for( int z = minz; z <= maxz; z++ ) {
-        zlev_dirty = false;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
-                submap * const current_submap = get_submap_at_grid( x, y, z );
+                submap *const current_submap = get_submap_at_grid( x, y, z );
+                if( current_submap->field_count <= 0 ) {
+                    continue;
+                }
+                auto &opaque = opaque_before[current_submap];
+                for( size_t i = 0; i < SEEX * SEEY; i++ ) {
+                    opaque[i].reset();
+                    if( current_submap->field_tiles[i] ) {
+                        opaque[i] = current_submap->fld[i / SEEY][i % SEEY].opaque_fields();
+                    }
+                }
+            }
+        }
+    }
+
+    for( int z = minz; z <= maxz; z++ ) {
+        for( int x = 0; x < my_MAPSIZE; x++ ) {
+            for( int y = 0; y < my_MAPSIZE; y++ ) {
+                submap *const current_submap = get_submap_at_grid( x, y, z );
                 if( current_submap->field_count > 0 ) {
-                    const bool cur_dirty = process_fields_in_submap( current_submap, x, y, z );
-                    zlev_dirty |= cur_dirty;
+                    process_fields_in_submap( current_submap, x, y, z );
                 }
             }
         }
+    }
 
-        if( zlev_dirty ) {
-            // For now, just always dirty the transparency cache
-            // when a field might possibly be changed.
-            // TODO: check if there are any fields(mostly fire)
-            //       that frequently change, if so set the dirty
-            //       flag, otherwise only set the dirty flag if
-            //       something actually changed
-            set_transparency_cache_dirty( z );
-            dirty_transparency_cache = true;
+    // Fields may have spread to any submap, check all of them.
+    bool dirty_transparency_cache = false;
+    for( int z = minz; z <= maxz; z++ ) {
+        for( int x = 0; x < my_MAPSIZE; x++ ) {
+            for( int y = 0; y < my_MAPSIZE; y++ ) {
+                submap *const current_submap = get_submap_at_grid( x, y, z );
+                auto &field_tiles = current_submap->field_tiles;
+                if( field_tiles.none() ) {
+                    continue;
+                }
+                const auto before = opaque_before.find( current_submap );
+                bool changed = false;
+                for( size_t i = 0; i < SEEX * SEEY; i++ ) {
+                    if( !field_tiles[i] ) {
+                        continue;
+                    }
+                    const field &fld = current_submap->fld[i / SEEY][i % SEEY];
+                    const auto opaque = fld.opaque_fields();
+                    if( before != opaque_before.end() ? opaque != before->second[i] : opaque.any() ) {
+                        changed = true;
+                    }
+                    if( fld.fieldCount() == 0 ) {
+                        field_tiles.reset( i );
+                    }
+                }
+                if( changed ) {
+                    set_transparency_cache_dirty( tripoint( x * SEEX, y * SEEY, z ) );
+                    dirty_transparency_cache = true;
+                }
+            }
         }
     }
 
@@ -454,7 +500,7 @@ Iterates over every field on every tile of the given submap given as parameter.
 This is the general update function for field effects. This should only be called once per game turn.
 If you need to insert a new field behavior per unit time add a case statement in the switch below.
 */
-bool map::process_fields_in_submap( submap *const current_submap,
+void map::process_fields_in_submap( submap *const current_submap,
                                     const int submap_x, const int submap_y, const int submap_z )
 {
     const auto get_neighbors = [this]( const tripoint &pt ) {
@@ -606,10 +652,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
         }
     };
 
-    // This should be true only when the field changes transparency
-    // More correctly: not just when the field is opaque, but when it changes state
-    // to a more/less transparent one, or creates a non-transparent field nearby
-    bool dirty_transparency_cache = false;
     //Holds m.field_at(x,y).findField(fd_some_field) type returns.
     // Just to avoid typing that long string for a temp value.
     field_entry *tmpfld = nullptr;
@@ -622,9 +664,12 @@ bool map::process_fields_in_submap( submap *const current_submap,
     maptile map_tile( current_submap, 0, 0 );
     size_t &locx = map_tile.x;
     size_t &locy = map_tile.y;
-    //Loop through all tiles in this submap indicated by current_submap
+    //Loop through all tiles in this submap that have fields
     for( locx = 0; locx < SEEX; locx++ ) {
         for( locy = 0; locy < SEEY; locy++ ) {
+            if( !current_submap->field_tiles[locx * SEEY + locy] ) {
+                continue;
+            }
             // This is a translation from local coordinates to submap coords.
             // All submaps are in one long 1d array.
             thep.x = locx + submap_x * SEEX;
@@ -634,18 +679,27 @@ bool map::process_fields_in_submap( submap *const current_submap,
             // Get a reference to the field variable from the submap;
             // contains all the pointers to the real field effects.
             field &curfield = current_submap->fld[locx][locy];
-            for( auto it = curfield.begin(); it != curfield.end();) {
+            // Processing can add fields to this tile, which moves the other entries around,
+            // so the next entry is looked up by type after the current one is done. Entries
+            // that died (while being processed or before) are removed here, too.
+            field_id processed_type = fd_null;
+            const auto next_entry = [&]() {
+                const field_entry *const processed = curfield.findField( processed_type );
+                if( processed != nullptr && !processed->isAlive() ) {
+                    current_submap->field_count--;
+                    curfield.removeField( processed_type );
+                }
+                return curfield.upper_bound( processed_type );
+            };
+            for( auto it = curfield.begin(); it != curfield.end(); it = next_entry() ) {
                 //Iterating through all field effects in the submap's field.
-                field_entry * cur = &it->second;
+                processed_type = it->first;
                 // The field might have been killed by processing a neighbour field
-                if( !cur->isAlive() ) {
-                    if( !fieldlist[cur->getFieldType()].transparent[cur->getFieldDensity() - 1] ) {
-                        dirty_transparency_cache = true;
-                    }
-                    current_submap->field_count--;
-                    curfield.removeField( it++ );
+                if( !it->second.isAlive() ) {
                     continue;
                 }
+                field_entry_copy cur_copy( curfield, it->second );
+                field_entry * cur = cur_copy.get();
 
                 curtype = cur->getFieldType();
                 // Again, legacy support in the event someone Mods setFieldDensity to allow more values.
@@ -732,10 +786,8 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         }
                         break;
                     case fd_plasma:
-                        dirty_transparency_cache = true;
                         break;
                     case fd_laser:
-                        dirty_transparency_cache = true;
                         break;
 
                         // TODO-MATERIALS: use fire resistance
@@ -1201,7 +1253,8 @@ bool map::process_fields_in_submap( submap *const current_submap,
                                     cur->setFieldAge( cur->getFieldAge() + MINUTES(1) );
                                 }
                                 if( nearwebfld ) {
-                                    nearwebfld->setFieldDensity( 0 );
+                                    // Adding the fire may have moved the web entry.
+                                    dst.find_field( fd_web )->setFieldDensity( 0 );
                                 }
                             }
                         }
@@ -1229,7 +1282,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                                     dst.add_field( fd_smoke, cur->getFieldDensity(), 0 );
                                 }
 
-                                dirty_transparency_cache = true; // Smoke affects transparency
                             }
 
                         // Hot air is a heavy load on the CPU and it doesn't do much
@@ -1242,22 +1294,18 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     break;
 
                     case fd_smoke:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 80, 50 );
                         break;
 
                     case fd_tear_gas:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 33, 30 );
                         break;
 
                     case fd_relax_gas:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 25, 50 );
                         break;
 
                     case fd_fungal_haze:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 33,  5);
                         if( one_in( 10 - 2 * cur->getFieldDensity() ) ) {
                             g->spread_fungus( p ); //Haze'd terrain
@@ -1266,18 +1314,15 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
 
                     case fd_toxic_gas:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 50, 30 );
                         break;
 
                     case fd_cigsmoke:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 250, 65 );
                         break;
 
                     case fd_weedsmoke:
                     {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 200, 60 );
 
                         if(one_in(20)) {
@@ -1295,7 +1340,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_methsmoke:
                     {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 175, 70 );
 
                         if(one_in(20)) {
@@ -1312,7 +1356,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_cracksmoke:
                     {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 175, 80 );
 
                         if(one_in(20)) {
@@ -1329,7 +1372,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_nuke_gas:
                     {
-                        dirty_transparency_cache = true;
                         int extra_radiation = rng(0, cur->getFieldDensity());
                         adjust_radiation( p, extra_radiation );
                         spread_gas( cur, p, curtype, 50, 10 );
@@ -1346,7 +1388,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_gas_vent:
                     {
-                        dirty_transparency_cache = true;
                         for( int i = -1; i <= 1; i++ ) {
                             for( int j = -1; j <= 1; j++ ) {
                                 const tripoint pnt( p.x + i, p.y + j, p.z );
@@ -1369,7 +1410,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                             }
                             create_hot_air( p, cur->getFieldDensity());
                         } else {
-                            dirty_transparency_cache = true;
                             add_field( p, fd_flame_burst, 3, cur->getFieldAge() );
                             cur->setFieldDensity( 0 );
                         }
@@ -1380,7 +1420,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                             cur->setFieldDensity(cur->getFieldDensity() - 1);
                             create_hot_air( p, cur->getFieldDensity());
                         } else {
-                            dirty_transparency_cache = true;
                             add_field( p, fd_fire_vent, 3, cur->getFieldAge() );
                             cur->setFieldDensity( 0 );
                         }
@@ -1576,7 +1615,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
 
                     case fd_bees:
-                        dirty_transparency_cache = true;
                         // Poor bees are vulnerable to so many other fields.
                         // TODO: maybe adjust effects based on different fields.
                         if( curfield.findField( fd_web ) ||
@@ -1631,7 +1669,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     case fd_incendiary:
                         {
                             //Needed for variable scope
-                            dirty_transparency_cache = true;
                             tripoint dst( p.x + rng( -1, 1 ), p.y + rng( -1, 1 ), p.z );
                             if( has_flag( TFLAG_FLAMMABLE, dst ) ||
                                 has_flag( TFLAG_FLAMMABLE_ASH, dst ) ||
@@ -1656,7 +1693,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_fungicidal_gas:
                         {
-                            dirty_transparency_cache = true;
                             spread_gas( cur, p, curtype, 120, 10 );
                             //check the terrain and replace it accordingly to simulate the fungus dieing off
                             const auto &ter = map_tile.get_ter_t();
@@ -1684,16 +1720,9 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     cur->setFieldAge( 0 );
                     cur->setFieldDensity( cur->getFieldDensity() - 1 );
                 }
-                if( !cur->isAlive() ) {
-                    current_submap->field_count--;
-                    curfield.removeField( it++ );
-                } else {
-                    ++it;
-                }
             }
         }
     }
-    return dirty_transparency_cache;
 }
 
 //This entire function makes very little sense. Why are the rules the way they are? Why does walking into some things destroy them but not others?
@@ -1724,8 +1753,14 @@ void map::player_in_field( player &u )
     // Iterate through all field effects on this tile.
     // Do not remove the field with removeField, instead set it's density to 0. It will be removed
     // later by the field processing, which will also adjust field_count accordingly.
-    for( auto field_list_it = curfield.begin(); field_list_it != curfield.end(); ++field_list_it){
-        field_entry * cur = &field_list_it->second;
+    // Hurting the player can spawn fields here (e.g. blood), hence the copies and the lookup
+    // of the next entry by type.
+    field_id cur_type = fd_null;
+    for( auto field_list_it = curfield.begin(); field_list_it != curfield.end();
+         field_list_it = curfield.upper_bound( cur_type ) ) {
+        cur_type = field_list_it->first;
+        field_entry_copy cur_copy( curfield, field_list_it->second );
+        field_entry * cur = cur_copy.get();
         if( !cur->isAlive() ) {
             continue;
         }
@@ -2186,8 +2221,14 @@ void map::monster_in_field( monster &z )
     // Iterate through all field effects on this tile.
     // Do not remove the field with removeField, instead set it's density to 0. It will be removed
     // later by the field processing, which will also adjust field_count accordingly.
-    for( auto field_list_it = curfield.begin(); field_list_it != curfield.end(); ++field_list_it ) {
-        field_entry * cur = &field_list_it->second;
+    // Hurting the monster can spawn fields here (e.g. blood), hence the copies and the lookup
+    // of the next entry by type.
+    field_id cur_type = fd_null;
+    for( auto field_list_it = curfield.begin(); field_list_it != curfield.end();
+         field_list_it = curfield.upper_bound( cur_type ) ) {
+        cur_type = field_list_it->first;
+        field_entry_copy cur_copy( curfield, field_list_it->second );
+        field_entry * cur = cur_copy.get();
         if( !cur->isAlive() ) {
             continue;
         }
@@ -2528,6 +2569,11 @@ field::~field()
 {
 }
 
+static bool entry_type_less( const std::pair<field_id, field_entry> &entry, const field_id type )
+{
+    return entry.first < type;
+}
+
 /*
 Function: findField
 Returns a field entry corresponding to the field_id parameter passed in. If no fields are found then returns NULL.
@@ -2535,17 +2581,14 @@ Good for checking for exitence of a field: if(myfield.findField(fd_fire)) would
 */
 field_entry *field::findField( const field_id field_to_find )
 {
-    const auto it = field_list.find( field_to_find );
-    if( it != field_list.end() ) {
-        return &it->second;
-    }
-    return nullptr;
+    return const_cast<field_entry *>( findFieldc( field_to_find ) );
 }
 
 const field_entry *field::findFieldc( const field_id field_to_find ) const
 {
-    const auto it = field_list.find( field_to_find );
-    if( it != field_list.end() ) {
+    const auto it = std::lower_bound( field_list.begin(), field_list.end(), field_to_find,
+                                      entry_type_less );
+    if( it != field_list.end() && it->first == field_to_find ) {
         return &it->second;
     }
     return nullptr;
@@ -2565,31 +2608,32 @@ If you wish to modify an already existing field use findField and modify the res
 Density defaults to 1, and age to 0 (permanent) if not specified.
 */
 bool field::addField(const field_id field_to_add, const int new_density, const int new_age){
-    auto it = field_list.find(field_to_add);
+    auto it = std::lower_bound( field_list.begin(), field_list.end(), field_to_add, entry_type_less );
     if (fieldlist[field_to_add].priority >= fieldlist[draw_symbol].priority)
         draw_symbol = field_to_add;
-    if(it != field_list.end()) {
+    if( it != field_list.end() && it->first == field_to_add ) {
         //Already exists, but lets update it. This is tentative.
         it->second.setFieldDensity(it->second.getFieldDensity() + new_density);
         return false;
     }
-    field_list[field_to_add] = field_entry(field_to_add, new_density, new_age);
+    field_list.emplace( it, field_to_add, field_entry( field_to_add, new_density, new_age ) );
     return true;
 }
 
 bool field::removeField( field_id const field_to_remove )
 {
-    const auto it = field_list.find( field_to_remove );
-    if( it == field_list.end() ) {
+    const auto it = std::lower_bound( field_list.begin(), field_list.end(), field_to_remove,
+                                      entry_type_less );
+    if( it == field_list.end() || it->first != field_to_remove ) {
         return false;
     }
     removeField( it );
     return true;
 }
 
-void field::removeField( std::map<field_id, field_entry>::iterator const it )
+field::iterator field::removeField( iterator const it )
 {
-        field_list.erase( it );
+        const auto next = field_list.erase( it );
         if( field_list.empty() ) {
             draw_symbol = fd_null;
         } else {
@@ -2600,6 +2644,7 @@ void field::removeField( std::map<field_id, field_entry>::iterator const it )
                 }
             }
         }
+        return next;
 }
 
 /*
@@ -2611,26 +2656,66 @@ unsigned int field::fieldCount() const
     return field_list.size();
 }
 
-std::map<field_id, field_entry>::iterator field::begin()
+field::iterator field::begin()
 {
     return field_list.begin();
 }
 
-std::map<field_id, field_entry>::const_iterator field::begin() const
+field::const_iterator field::begin() const
 {
     return field_list.begin();
 }
 
-std::map<field_id, field_entry>::iterator field::end()
+field::iterator field::end()
 {
     return field_list.end();
 }
 
-std::map<field_id, field_entry>::const_iterator field::end() const
+field::const_iterator field::end() const
 {
     return field_list.end();
 }
 
+field::iterator field::upper_bound( const field_id type )
+{
+    return std::upper_bound( field_list.begin(), field_list.end(), type,
+    []( const field_id type, const std::pair<field_id, field_entry> &entry ) {
+        return type < entry.first;
+    } );
+}
+
+size_t field_opacity_bit( const field_id type, const int density )
+{
+    return type * 3 + density - 1;
+}
+
+std::bitset<num_fields * 3> field::opaque_fields() const
+{
+    std::bitset<num_fields * 3> result;
+    for( auto &fld : field_list ) {
+        const int density = fld.second.getFieldDensity();
+        if( !fieldlist[fld.first].transparent[density - 1] ) {
+            result.set( field_opacity_bit( fld.first, density ) );
+        }
+    }
+    return result;
+}
+
+void field::merge_entry( const field_entry &original, const field_entry &changed )
+{
+    field_entry *const stored = findField( original.getFieldType() );
+    if( stored == nullptr ) {
+        return;
+    }
+    stored->setFieldAge( stored->getFieldAge() + changed.getFieldAge() - original.getFieldAge() );
+    if( !changed.isAlive() ) {
+        stored->setFieldDensity( 0 );
+    } else {
+        stored->setFieldDensity( stored->getFieldDensity() + changed.getFieldDensity() -
+                                 original.getFieldDensity() );
+    }
+}
+
 /*
 Function: fieldSymbol
 Returns the last added field from the tile for drawing purposes.
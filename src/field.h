@@ -6,6 +6,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <bitset>
+#include <utility>
 #include <iosfwd>
 
 /*
@@ -101,6 +103,9 @@ extern field_t fieldlist[num_fields];
  */
 extern field_id field_from_ident(const std::string &field_ident);
 
+/** Index of the field type at that density (1 - 3) in @ref field::opaque_fields. */
+size_t field_opacity_bit( field_id type, int density );
+
 /**
  * Returns if the field has at least one intensity for which dangerous[intensity] is true.
  */
@@ -163,7 +168,7 @@ public:
     }
 
     //Returns true if this is an active field, false if it should be removed.
-    bool isAlive(){
+    bool isAlive() const {
         return is_alive;
     }
 
@@ -181,9 +186,15 @@ private:
  * Use @ref findField to get the field entry of a specific type, or iterate over
  * all entries via @ref begin and @ref end (allows range based iteration).
  * There is @ref fieldSymbol to specific which field should be drawn on the map.
+ * The entries are kept in a vector sorted by field type, adding or removing entries
+ * invalidates pointers and iterators to the other entries.
 */
 class field{
 public:
+    using entry_list = std::vector<std::pair<field_id, field_entry>>;
+    using iterator = entry_list::iterator;
+    using const_iterator = entry_list::const_iterator;
+
     field();
     ~field();
 
@@ -222,8 +233,9 @@ public:
     /**
      * Make sure to decrement the field counter in the submap.
      * Removes the field entry, the iterator must point into @ref field_list and must be valid.
+     * @return Iterator to the entry following the removed one.
      */
-    void removeField( std::map<field_id, field_entry>::iterator );
+    iterator removeField( iterator it );
 
     //Returns the number of fields existing on the current tile.
     unsigned int fieldCount() const;
@@ -234,12 +246,35 @@ public:
     field_id fieldSymbol() const;
 
     //Returns the vector iterator to begin searching through the list.
-    std::map<field_id, field_entry>::iterator begin();
-    std::map<field_id, field_entry>::const_iterator begin() const;
+    iterator begin();
+    const_iterator begin() const;
 
     //Returns the vector iterator to end searching through the list.
-    std::map<field_id, field_entry>::iterator end();
-    std::map<field_id, field_entry>::const_iterator end() const;
+    iterator end();
+    const_iterator end() const;
+
+    /**
+     * Returns the first entry with a type greater than the given one (or @ref end).
+     * Allows to continue iterating after entries have been added or removed.
+     */
+    iterator upper_bound( field_id type );
+
+    /**
+     * Returns the field types on this tile that are not transparent, one bit per type and
+     * density (see @ref field_opacity_bit). The transparency of the tile depends on those
+     * only, it can't change as long as they don't.
+     */
+    std::bitset<num_fields * 3> opaque_fields() const;
+
+    /**
+     * Applies the changes made to a copy of one of the entries to the stored entry.
+     * Only the differences between original and changed are applied, so changes that
+     * were made to the stored entry in the meantime are kept. Does nothing if the entry
+     * doesn't exist anymore.
+     * @param original The entry as it was when the copy was made.
+     * @param changed The copy.
+     */
+    void merge_entry( const field_entry &original, const field_entry &changed );
 
     /**
      * Returns the total move cost from all fields.
@@ -247,8 +282,37 @@ public:
     int move_cost() const;
 
 private:
-    std::map<field_id, field_entry> field_list; //A pointer lookup table of all field effects on the current tile.    //Draw_symbol currently is equal to the last field added to the square. You can modify this behavior in the class functions if you wish.
+    entry_list field_list; //All field effects on the current tile, sorted by their type.
+    //Draw_symbol currently is equal to the last field added to the square. You can modify this behavior in the class functions if you wish.
     field_id draw_symbol;
 };
 
+/**
+ * A working copy of a field entry that is merged back (see @ref field::merge_entry) when
+ * this goes out of scope.
+ * Adding a field to a tile moves the other entries of that tile in memory. Code that holds
+ * on to an entry while doing something that may spawn fields on the same tile (e.g. a dying
+ * monster leaving blood) must work on this instead of a pointer to the stored entry.
+ */
+class field_entry_copy {
+public:
+    field_entry_copy( field &owner, const field_entry &entry )
+        : owner( owner ), original( entry ), current( entry ) {
+    }
+    field_entry_copy( const field_entry_copy & ) = delete;
+    field_entry_copy &operator=( const field_entry_copy & ) = delete;
+    ~field_entry_copy() {
+        owner.merge_entry( original, current );
+    }
+
+    field_entry *get() {
+        return &current;
+    }
+
+private:
+    field &owner;
+    const field_entry original;
+    field_entry current;
+};
+
 #endif
@@ -11,6 +11,8 @@
 #include <deque>
 #include <algorithm>
 #include <memory>
+#include <fstream>
+#include <iterator>
 
 // FILE I/O
 #include <sys/stat.h>
@@ -23,6 +25,12 @@
 #   include <unistd.h>
 #endif
 
+#if !(defined _WIN32 || defined __WIN32__)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   define CATA_HAS_MMAP
+#endif
+
 #if defined(_WIN32) || defined (__WIN32__)
 #   include "platform_win.h"
 #endif
@@ -320,3 +328,81 @@ std::vector<std::string> get_directories_with(std::vector<std::string> const &pa
 
     return files;
 }
+
+#ifdef CATA_HAS_MMAP
+mapped_file::mapped_file( const std::string &path )
+{
+    const int fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 ) {
+        return;
+    }
+    struct stat file_stat;
+    if( fstat( fd, &file_stat ) == 0 ) {
+        size_ = file_stat.st_size;
+        if( size_ == 0 ) {
+            // mmap refuses empty mappings, but an empty file is still a valid file.
+            is_open_ = true;
+        } else {
+            void *const mapping = mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( mapping != MAP_FAILED ) {
+                data_ = static_cast<const char *>( mapping );
+                is_open_ = true;
+            }
+        }
+    }
+    close( fd );
+}
+
+mapped_file::~mapped_file()
+{
+    if( data_ != nullptr ) {
+        munmap( const_cast<char *>( data_ ), size_ );
+    }
+}
+#else
+mapped_file::mapped_file( const std::string &path )
+{
+    std::ifstream fin( path.c_str(), std::ios::binary );
+    if( !fin.is_open() ) {
+        return;
+    }
+    buffer.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+    data_ = buffer.data();
+    size_ = buffer.size();
+    is_open_ = true;
+}
+
+mapped_file::~mapped_file() = default;
+#endif
+
+memory_streambuf::memory_streambuf( const char *data, const size_t size )
+{
+    // The get area is never written to, std::streambuf just doesn't know about const.
+    char *const begin = const_cast<char *>( data );
+    setg( begin, begin, begin + size );
+}
+
+memory_streambuf::pos_type memory_streambuf::seekoff( const off_type off,
+        const std::ios_base::seekdir dir, const std::ios_base::openmode which )
+{
+    if( !( which & std::ios_base::in ) ) {
+        return pos_type( off_type( -1 ) );
+    }
+    char *base = gptr();
+    if( dir == std::ios_base::beg ) {
+        base = eback();
+    } else if( dir == std::ios_base::end ) {
+        base = egptr();
+    }
+    if( off < eback() - base || off > egptr() - base ) {
+        return pos_type( off_type( -1 ) );
+    }
+    setg( eback(), base + off, egptr() );
+    return pos_type( gptr() - eback() );
+}
+
+memory_streambuf::pos_type memory_streambuf::seekpos( const pos_type pos,
+        const std::ios_base::openmode which )
+{
+    return seekoff( off_type( pos ), std::ios_base::beg, which );
+}
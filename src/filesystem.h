@@ -1,6 +1,7 @@
 #ifndef CATA_FILE_SYSTEM_H
 #define CATA_FILE_SYSTEM_H
 
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -41,4 +42,53 @@ std::vector<std::string> get_directories_with( std::vector<std::string> const &p
 
 std::vector<std::string> get_directories_with( std::string const &pattern,
         std::string const &root_path = "", bool const recurse = false );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read-only view of the whole content of a file. The file is memory mapped where the platform
+ * supports it, otherwise it is read into memory.
+ */
+class mapped_file
+{
+    public:
+        /** Opens the file, check @ref is_open to see whether that worked. */
+        explicit mapped_file( const std::string &path );
+        ~mapped_file();
+
+        mapped_file( const mapped_file & ) = delete;
+        mapped_file &operator=( const mapped_file & ) = delete;
+
+        bool is_open() const {
+            return is_open_;
+        }
+        const char *data() const {
+            return data_;
+        }
+        size_t size() const {
+            return size_;
+        }
+
+    private:
+        bool is_open_ = false;
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+        /** Only used when the file could not be mapped. */
+        std::vector<char> buffer;
+};
+
+/**
+ * Read-only stream buffer over memory that is owned by someone else, usually a
+ * @ref mapped_file. Allows reading it through a std::istream (e.g. with @ref JsonIn)
+ * without copying it. Supports seeking.
+ */
+class memory_streambuf : public std::streambuf
+{
+    public:
+        memory_streambuf( const char *data, size_t size );
+
+    protected:
+        pos_type seekoff( off_type off, std::ios_base::seekdir dir,
+                          std::ios_base::openmode which ) override;
+        pos_type seekpos( pos_type pos, std::ios_base::openmode which ) override;
+};
 #endif //CATA_FILE_SYSTEM_H
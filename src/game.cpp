@@ -69,6 +69,7 @@
 #include "event.h"
 #include "coordinates.h"
 #include "creature_tracker.h"
+#include "scent_map.h"
 #include "vehicle.h"
 #include "submap.h"
 #include "mapgen_functions.h"
@@ -87,6 +88,7 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -203,6 +205,7 @@ game::game() :
     pixel_minimap_option(0),
     safe_mode(SAFE_MODE_ON),
     mostseen(0),
+    scent_diffuser( new scent_diffusion() ),
     gamemode(NULL),
     user_action_counter(0),
     lookHeight(13),
@@ -678,6 +681,7 @@ void game::setup()
     sounds::reset_sounds();
     clear_zombies();
     coming_to_stairs.clear();
+    submaps_ahead.clear();
     active_npc.clear();
     mission_npc.clear();
     factions.clear();
@@ -726,7 +730,7 @@ bool game::start_game(std::string worldname)
     new_game = true;
     start_calendar();
     nextweather = calendar::turn;
-    weather_gen->set_seed( rand() );
+    weather_gen->set_seed( rng( 0, INT_MAX ) );
     safe_mode = (OPTIONS["SAFEMODE"] ? SAFE_MODE_ON : SAFE_MODE_OFF);
     mostseen = 0; // ...and mostseen is 0, we haven't seen any monsters yet.
 
@@ -1472,6 +1476,7 @@ bool game::do_turn()
     sfx::remove_hearing_loss();
     sfx::do_danger_music();
     sfx::do_fatigue();
+    generate_submaps_ahead();
 
     return false;
 }
@@ -3248,104 +3253,23 @@ void game::update_scent()
 
     overmap_buffer.set_scent( u.global_omt_location(), u.scent );
 
-    // note: the next four intermediate matrices need to be at least
-    // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
-    // The code I'm modifying used [SEEX * MAPSIZE]. I'm staying with that to avoid new bugs.
-
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    int sum_3_scent_y[SEEY * MAPSIZE][SEEX * MAPSIZE];  //intermediate variable
-    int squares_used_y[SEEY * MAPSIZE][SEEX * MAPSIZE]; //intermediate variable
-
-    // these are for caching flag lookups
-    bool blocks_scent[SEEX * MAPSIZE][SEEY * MAPSIZE]; // currently only TFLAG_WALL blocks scent
-    bool reduces_scent[SEEX * MAPSIZE][SEEY * MAPSIZE];
-
-
     // for loop constants
     const int scentmap_minx = u.posx() - SCENT_RADIUS;
     const int scentmap_maxx = u.posx() + SCENT_RADIUS;
     const int scentmap_miny = u.posy() - SCENT_RADIUS;
     const int scentmap_maxy = u.posy() + SCENT_RADIUS;
 
-    const int diffusivity = 100; // decrease this to reduce gas spread. Keep it under 125 for
-    // stability. This is essentially a decimal number * 1000.
-
     // No-scent debug mutation has to be processed here or else it takes time to start working
     if( !u.has_active_bionic("bio_scent_mask") && !u.has_trait("DEBUG_NOSCENT") ) {
         grscent[u.posx()][u.posy()] = u.scent;
     }
 
-    // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( blocks_scent, reduces_scent,
-                      scentmap_minx, scentmap_miny, scentmap_maxx, scentmap_maxy );
-    // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
-    // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
-    // note: this method needs an array that is one square larger on each side in the x direction
-    // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
-    // SEEX*MAPSIZE, but if that changes, this may need tweaking.
-    for (int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x) {
-        for (int y = scentmap_miny; y <= scentmap_maxy; ++y) {
-            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for (int i = y - 1; i <= y + 1; ++i) {
-                if (! blocks_scent[x][i]) {
-                    if (reduces_scent[x][i]) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
-        }
-    }
-
-    // Rest of the scent map
-    for (int x = scentmap_minx; x <= scentmap_maxx; ++x) {
-        for (int y = scentmap_miny; y <= scentmap_maxy; ++y) {
-            if (! blocks_scent[x][y]) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                int squares_used = squares_used_y[y][x - 1]
-                                   + squares_used_y[y][x]
-                                   + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if (! reduces_scent[x][y]) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                int temp_scent;
-                // take the old scent and subtract what diffuses out
-                temp_scent = grscent[x][y] * (10 * 1000 - squares_used * this_diffusivity);
-                // neighboring walls and reduce_scent squares absorb some scent
-                temp_scent -= grscent[x][y] * this_diffusivity * (90 - squares_used) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                grscent[x][y] =
-                    (temp_scent
-                     + this_diffusivity * (sum_3_scent_y[y][x - 1]
-                                           + sum_3_scent_y[y][x]
-                                           + sum_3_scent_y[y][x + 1])
-                    ) / (1000 * 10);
-
-                if (grscent[x][y] > 10000) {
-                    dbg(D_ERROR) << "game:update_scent: Wacky scent at " << x << ","
-                                 << y << " (" << grscent[x][y] << ")";
-                    debugmsg("Wacky scent at %d, %d (%d)", x, y, grscent[x][y]);
-                    grscent[x][y] = 0; // Scent should never be higher
-                }
-            } else { // this cell blocks scent
-                grscent[x][y] = 0;
-            }
-        }
-    }
+    // The diffusion also reads a one tile border around the scent map
+    scent_diffuser->clear_blockers( scentmap_minx - 1, scentmap_miny - 1,
+                                    scentmap_maxx + 1, scentmap_maxy + 1 );
+    m.scent_blockers( scent_diffuser->blocks_scent, scent_diffuser->reduces_scent,
+                      scentmap_minx - 1, scentmap_miny - 1, scentmap_maxx + 1, scentmap_maxy + 1 );
+    scent_diffuser->diffuse( grscent, scentmap_minx, scentmap_miny, scentmap_maxx, scentmap_maxy );
 }
 
 bool game::is_game_over()
@@ -3576,6 +3500,10 @@ void game::load_world_modfiles(WORLDPTR world)
         load_data_from_dir(world->world_path + "/mods");
     }
     DynamicDataLoader::get_instance().finalize_loaded_data();
+#ifdef TILES
+    // The int ids of terrain and so on have changed.
+    tilecontext->invalidate_tile_lookups();
+#endif // TILES
 }
 
 //Saves all factions and missions and npcs.
@@ -13681,6 +13609,7 @@ void game::update_map(int &x, int &y)
 
     // this handles loading/unloading submaps that have scrolled on or off the viewport
     m.shift( shiftx, shifty );
+    prefetch_submaps( shiftx, shifty );
 
     // Shift monsters
     shift_monsters( shiftx, shifty, 0 );
@@ -13738,6 +13667,63 @@ void game::update_map(int &x, int &y)
     update_overmap_seen();
 }
 
+void game::prefetch_submaps( const int shiftx, const int shifty )
+{
+    // Travel direction: the one of the vehicle the player is in, otherwise the last shift.
+    const vehicle *veh = u.in_vehicle ? m.veh_at( u.pos() ) : nullptr;
+    const bool driving = veh != nullptr && veh->velocity != 0;
+    rl_vec2d dir = !driving ? rl_vec2d( shiftx, shifty ) :
+                   veh->velocity > 0 ? veh->move_vec() : -veh->move_vec();
+    int lookahead = 1;
+    if( driving ) {
+        // A vehicle moves about velocity / 1000 tiles per turn on roads (see map::vehproceed).
+        // Reach far enough for the next few turns, more would only waste memory.
+        static const int prefetch_turns = 10;
+        static const int max_lookahead = 3;
+        const int tiles = std::abs( veh->velocity ) * prefetch_turns / 1000;
+        lookahead = std::min( 1 + tiles / SEEX, max_lookahead );
+    }
+    if( dir.norm() == 0 ) {
+        return;
+    }
+    const rl_vec2d unit = dir.normalized();
+    // Directions within 22.5 degrees of an axis only load along that axis.
+    const int dx = unit.x > 0.38 ? 1 : ( unit.x < -0.38 ? -1 : 0 );
+    const int dy = unit.y > 0.38 ? 1 : ( unit.y < -0.38 ? -1 : 0 );
+
+    // Submaps queued for the previous direction are not needed that urgently anymore.
+    submaps_ahead.clear();
+    const tripoint origin = m.get_abs_sub();
+    const auto ahead = [this]( const tripoint & p ) {
+        MAPBUFFER.prefetch( p );
+        submaps_ahead.push_back( p );
+    };
+    for( int k = 1; k <= lookahead; k++ ) {
+        for( int i = 0; i < MAPSIZE; i++ ) {
+            if( dx != 0 ) {
+                const int x = dx > 0 ? MAPSIZE - 1 + k : -k;
+                ahead( origin + tripoint( x, i + dy * k, 0 ) );
+            }
+            if( dy != 0 ) {
+                const int y = dy > 0 ? MAPSIZE - 1 + k : -k;
+                ahead( origin + tripoint( i + dx * k, y, 0 ) );
+            }
+        }
+    }
+}
+
+void game::generate_submaps_ahead()
+{
+    // Only a few milliseconds per turn, the rest is done by the next turns or by map::shift.
+    static const auto budget = std::chrono::milliseconds( 10 );
+    const auto start = std::chrono::steady_clock::now();
+    while( !submaps_ahead.empty() && std::chrono::steady_clock::now() - start < budget ) {
+        const tripoint p = submaps_ahead.front();
+        submaps_ahead.erase( submaps_ahead.begin() );
+        map::load_or_generate_submap( p );
+    }
+}
+
 void game::update_overmap_seen()
 {
     const tripoint ompos = u.global_omt_location();
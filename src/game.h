@@ -90,6 +90,7 @@ class npc;
 class monster;
 class vehicle;
 class Creature_tracker;
+class scent_diffusion;
 class calendar;
 class scenario;
 class DynamicDataLoader;
@@ -752,6 +753,20 @@ private:
         void despawn_monster(int mondex);
 
         void spawn_mon(int shift, int shifty); // Called by update_map, sometimes
+        /**
+         * Called by update_map: lets the @ref mapbuffer read the submaps that are likely to
+         * be loaded next in the background, based on the movement of the player's vehicle
+         * or the last shift of the map. They are queued for @ref generate_submaps_ahead too.
+         */
+        void prefetch_submaps( int shiftx, int shifty );
+        /**
+         * Called at the end of each turn: loads or generates some of the submaps
+         * queued by @ref prefetch_submaps, so that shifting the map later on does not
+         * have to generate a whole row of overmap tiles at once.
+         */
+        void generate_submaps_ahead();
+        /** Submaps (absolute submap coordinates) to load or generate ahead, nearest first. */
+        std::vector<tripoint> submaps_ahead;
         void rebuild_mon_at_cache();
 
         // Routine loop functions, approximately in order of execution
@@ -831,6 +846,7 @@ private:
         calendar nextweather; // The turn on which weather will shift next.
         int next_npc_id, next_faction_id, next_mission_id; // Keep track of UIDs
         int grscent[SEEX *MAPSIZE][SEEY *MAPSIZE];   // The scent map
+        std::unique_ptr<scent_diffusion> scent_diffuser; // Spreads scent on grscent
         int nulscent;    // Returned for OOB scent checks
         std::list<event> events;         // Game events to be processed
         std::map<mtype_id, int> kills;         // Player's kill count
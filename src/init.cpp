@@ -53,6 +53,8 @@
 #include "gates.h"
 #include "overlay_ordering.h"
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <fstream>
@@ -77,6 +79,15 @@ DynamicDataLoader &DynamicDataLoader::get_instance()
     return theDynamicDataLoader;
 }
 
+namespace {
+
+double seconds_since( const std::chrono::steady_clock::time_point &start )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+}
+
 void DynamicDataLoader::load_object(JsonObject &jo)
 {
     std::string type = jo.get_string("type");
@@ -84,7 +95,15 @@ void DynamicDataLoader::load_object(JsonObject &jo)
     if (it == type_function_map.end()) {
         jo.throw_error( "unrecognized JSON object", "type" );
     }
+    if( !timing ) {
+        (*it->second)(jo);
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
     (*it->second)(jo);
+    load_time &time = load_times[type];
+    time.seconds += seconds_since( start );
+    time.objects++;
 }
 
 void load_ingored_type(JsonObject &jo)
@@ -256,18 +275,19 @@ void DynamicDataLoader::load_data_from_path(const std::string &path)
             files.push_back(path);
         }
     }
+    const auto start = std::chrono::steady_clock::now();
     // iterate over each file
     for( auto &files_i : files ) {
         const std::string &file = files_i;
-        // open the file as a stream
-        std::ifstream infile(file.c_str(), std::ifstream::in | std::ifstream::binary);
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                (std::istreambuf_iterator<char>(infile)),
-                std::istreambuf_iterator<char>()
-            )
-        );
+        // map the file into memory and read it in place
+        const mapped_file content( file );
+        if( !content.is_open() ) {
+            throw std::runtime_error( file + ": could not be opened" );
+        }
+        loaded_data_hash.add( file );
+        loaded_data_hash.add( content.data(), content.size() );
+        memory_streambuf buffer( content.data(), content.size() );
+        std::istream iss( &buffer );
         try {
             // parse it
             JsonIn jsin(iss);
@@ -276,6 +296,7 @@ void DynamicDataLoader::load_data_from_path(const std::string &path)
             throw std::runtime_error( file + ": " + err.what() );
         }
     }
+    total_load_seconds += seconds_since( start );
 }
 
 void DynamicDataLoader::load_all_from_json(JsonIn &jsin)
@@ -322,6 +343,7 @@ void init_names()
 
 void DynamicDataLoader::unload_data()
 {
+    loaded_data_hash = content_hash();
     vitamin::reset();
     fault::reset();
     material_type::reset();
@@ -372,21 +394,82 @@ void DynamicDataLoader::unload_data()
 extern void calculate_mapgen_weights();
 void DynamicDataLoader::finalize_loaded_data()
 {
-    item_controller->finalize();
-    mission_type::initialize(); // Needs overmap terrain.
-    set_ter_ids();
-    set_furn_ids();
-    set_oter_ids();
-    trap::finalize();
-    finalize_overmap_terrain();
-    vehicle_prototype::finalize();
-    calculate_mapgen_weights();
-    MonsterGenerator::generator().finalize_mtypes();
-    MonsterGroupManager::FinalizeMonsterGroups();
-    monfactions::finalize();
-    finalize_recipes();
-    finialize_martial_arts();
-    check_consistency();
+    const auto step = [this]( const char *name, const std::function<void()> &func ) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        if( timing ) {
+            finalize_times.emplace_back( name, seconds_since( start ) );
+        }
+    };
+    step( "items", []() {
+        item_controller->finalize();
+    } );
+    step( "mission types", &mission_type::initialize ); // Needs overmap terrain.
+    step( "terrain ids", &set_ter_ids );
+    step( "furniture ids", &set_furn_ids );
+    step( "overmap terrain ids", &set_oter_ids );
+    step( "traps", &trap::finalize );
+    step( "overmap terrain", &finalize_overmap_terrain );
+    step( "vehicle prototypes", &vehicle_prototype::finalize );
+    step( "mapgen weights", &calculate_mapgen_weights );
+    step( "monster types", []() {
+        MonsterGenerator::generator().finalize_mtypes();
+    } );
+    step( "monster groups", &MonsterGroupManager::FinalizeMonsterGroups );
+    step( "monster factions", &monfactions::finalize );
+    step( "recipes", &finalize_recipes );
+    step( "martial arts", &finialize_martial_arts );
+    step( "consistency checks", [this]() {
+        check_consistency();
+    } );
+    if( timing ) {
+        report_timing();
+    }
+}
+
+void DynamicDataLoader::set_timing( const bool enable )
+{
+    timing = enable;
+}
+
+uint64_t DynamicDataLoader::data_hash() const
+{
+    return loaded_data_hash.value();
+}
+
+void DynamicDataLoader::report_timing()
+{
+    std::vector<std::pair<type_string, load_time>> types( load_times.begin(), load_times.end() );
+    std::sort( types.begin(), types.end(), []( const std::pair<type_string, load_time> &a,
+    const std::pair<type_string, load_time> &b ) {
+        return a.second.seconds > b.second.seconds;
+    } );
+    double total_type_seconds = 0;
+    for( auto &elem : types ) {
+        total_type_seconds += elem.second.seconds;
+    }
+
+    std::ostringstream report;
+    report << string_format( "Game data loaded in %.3f s, %.3f s of it in the type loaders "
+                             "(the rest is reading and skipping JSON):", total_load_seconds,
+                             total_type_seconds );
+    for( auto &elem : types ) {
+        report << string_format( "\n  %-25s %6d objects %9.3f ms", elem.first.c_str(),
+                                 elem.second.objects, elem.second.seconds * 1000 );
+    }
+    double total_finalize_seconds = 0;
+    for( auto &elem : finalize_times ) {
+        total_finalize_seconds += elem.second;
+    }
+    report << string_format( "\nGame data finalized in %.3f s:", total_finalize_seconds );
+    for( auto &elem : finalize_times ) {
+        report << string_format( "\n  %-25s %9.3f ms", elem.first.c_str(), elem.second * 1000 );
+    }
+    DebugLog( D_INFO, D_MAIN ) << report.str();
+
+    load_times.clear();
+    finalize_times.clear();
+    total_load_seconds = 0;
 }
 
 void DynamicDataLoader::check_consistency()
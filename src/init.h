@@ -2,6 +2,7 @@
 #define INIT_H
 
 #include "json.h"
+#include "snapshot.h"
 
 #include <string>
 #include <vector>
@@ -156,6 +157,24 @@ class DynamicDataLoader
          */
         void check_consistency();
 
+        /** Whether @ref load_times and @ref finalize_times are collected. */
+        bool timing = false;
+        struct load_time {
+            double seconds = 0;
+            int objects = 0;
+        };
+        /** Time spent in the loading functions, per type. */
+        std::map<type_string, load_time> load_times;
+        /** Time spent in each step of @ref finalize_loaded_data, in order. */
+        std::vector<std::pair<std::string, double>> finalize_times;
+        /** Seconds spent in @ref load_data_from_path. */
+        double total_load_seconds = 0;
+        /** Writes the collected times to the debug log and resets them. */
+        void report_timing();
+
+        /** Hash of the paths and contents of the files loaded since @ref unload_data. */
+        content_hash loaded_data_hash;
+
     public:
         /**
          * Returns the single instance of this class.
@@ -183,6 +202,16 @@ class DynamicDataLoader
          * @ref check_consistency
          */
         void finalize_loaded_data();
+        /**
+         * Enables measuring how long loading each type and each finalization step takes.
+         * The report is written to the debug log by @ref finalize_loaded_data.
+         */
+        void set_timing( bool enable );
+        /**
+         * Identifies the data (and the mods) loaded since the last @ref unload_data, snapshots
+         * of things derived from that data use it to tell whether they are still valid.
+         */
+        uint64_t data_hash() const;
 };
 
 void init_names();
@@ -46,6 +46,11 @@
 
 static const std::string GUN_MODE_VAR_NAME( "item::mode" );
 
+static const flag_id flag_CABLE_SPOOL( "CABLE_SPOOL" );
+static const flag_id flag_LITCIG( "LITCIG" );
+static const flag_id flag_RADIO_ACTIVATION( "RADIO_ACTIVATION" );
+static const flag_id flag_WET( "WET" );
+
 const skill_id skill_survival( "survival" );
 const skill_id skill_melee( "melee" );
 const skill_id skill_bashing( "bashing" );
@@ -1601,7 +1606,7 @@ std::string item::info( bool showtext, std::vector<iteminfo> &info ) const
                 info.push_back( iteminfo( "DESCRIPTION",
                     _( "* This tool has a <info>rechargeable power cell</info> and can be recharged in any <neutral>UPS-compatible recharging station</neutral>. You could charge it with <info>standard batteries</info>, but unloading it is impossible." ) ) );
             }
-            if( has_flag( "RADIO_ACTIVATION" ) ) {
+            if( has_flag( flag_RADIO_ACTIVATION ) ) {
                 if( has_flag( "RADIO_MOD" ) ) {
                     info.push_back( iteminfo( "DESCRIPTION",
                                               _( "* This item has been modified to listen to <info>radio signals</info>.  It can still be activated manually." ) ) );
@@ -1937,9 +1942,9 @@ nc_color item::color_in_inventory() const
     player* const u = &g->u; // TODO: make a reference, make a const reference
     nc_color ret = c_ltgray;
 
-    if(has_flag("WET")) {
+    if(has_flag(flag_WET)) {
         ret = c_cyan;
-    } else if(has_flag("LITCIG")) {
+    } else if(has_flag(flag_LITCIG)) {
         ret = c_red;
     } else if ( has_flag("LEAK_DAM") && has_flag("RADIOACTIVE") && damage > 0 ) {
         ret = c_ltgreen;
@@ -2285,10 +2290,10 @@ std::string item::tname( unsigned int quantity, bool with_prefix ) const
         modtext += _( "sawn-off ");
     }
 
-    if(has_flag("WET"))
+    if(has_flag(flag_WET))
        ret << _(" (wet)");
 
-    if(has_flag("LITCIG"))
+    if(has_flag(flag_LITCIG))
         ret << _(" (lit)");
 
     if( already_used_by_player( g->u ) ) {
@@ -2629,6 +2634,11 @@ void item::unset_flags()
 }
 
 bool item::has_flag( const std::string &f ) const
+{
+    return has_flag( flag_id( f ) );
+}
+
+bool item::has_flag( const flag_id &f ) const
 {
     bool ret = false;
     // TODO: this might need checking against the firing code, that code should use the
@@ -2651,14 +2661,12 @@ bool item::has_flag( const std::string &f ) const
         }
     }
     // other item type flags
-    ret = type->item_tags.count(f);
-    if (ret) {
-        return ret;
+    if( type->has_flag( f ) ) {
+        return true;
     }
 
     // now check for item specific flags
-    ret = item_tags.count(f);
-    return ret;
+    return !item_tags.empty() && item_tags.count( f.str() ) > 0;
 }
 
 bool item::has_any_flag( const std::vector<std::string>& flags ) const
@@ -5289,7 +5297,7 @@ std::string item::components_to_string() const
 
 bool item::needs_processing() const
 {
-    return active || has_flag("RADIO_ACTIVATION") ||
+    return active || has_flag( flag_RADIO_ACTIVATION ) ||
            ( is_container() && !contents.empty() && contents[0].needs_processing() ) ||
            is_artifact();
 }
@@ -5585,14 +5593,14 @@ bool item::process( player *carrier, const tripoint &pos, bool activate )
     if( is_corpse() && process_corpse( carrier, pos ) ) {
         return true;
     }
-    if( has_flag( "WET" ) && process_wet( carrier, pos ) ) {
+    if( has_flag( flag_WET ) && process_wet( carrier, pos ) ) {
         // Drying items are never destroyed, but we want to exit so they don't get processed as tools.
         return false;
     }
-    if( has_flag( "LITCIG" ) && process_litcig( carrier, pos ) ) {
+    if( has_flag( flag_LITCIG ) && process_litcig( carrier, pos ) ) {
         return true;
     }
-    if( has_flag( "CABLE_SPOOL" ) ) {
+    if( has_flag( flag_CABLE_SPOOL ) ) {
         // DO NOT process this as a tool! It really isn't!
         return process_cable(carrier, pos);
     }
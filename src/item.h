@@ -16,6 +16,7 @@
 #include "string_id.h"
 #include "line.h"
 #include "item_location.h"
+#include "item_flag.h"
 
 class game;
 class Character;
@@ -915,6 +916,8 @@ public:
          */
         /*@{*/
         bool has_flag( const std::string& flag ) const;
+        /** Faster than the above, the flag of the item type is a bit lookup. */
+        bool has_flag( const flag_id &flag ) const;
         bool has_any_flag( const std::vector<std::string>& flags ) const;
         /** Removes all item specific flags. */
         void unset_flags();
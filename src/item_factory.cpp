@@ -123,6 +123,7 @@ void Item_factory::finalize() {
 
         set_allergy_flags( *e.second );
         hflesh_to_flesh( *e.second );
+        obj.intern_flags();
 
         // default vitamins of healthy comestibles to their edible base materials if none explicitly specified
         if( obj.comestible && obj.comestible->vitamins.empty() && obj.comestible->healthy >= 0 ) {
@@ -773,6 +774,7 @@ void Item_factory::add_item_type(itype *new_type)
         debugmsg( "called Item_factory::add_item_type with nullptr" );
         return;
     }
+    new_type->intern_flags();
     m_templates[ new_type->id ].reset( new_type );
 }
 
@@ -0,0 +1,40 @@
+#include "item_flag.h"
+
+#include <deque>
+#include <unordered_map>
+
+namespace
+{
+
+struct flag_registry {
+    std::unordered_map<std::string, size_t> indices;
+    // A deque, so references returned by flag_id::str stay valid when more flags are added.
+    std::deque<std::string> names;
+};
+
+// Function local, flag_id constants are created during static initialization.
+flag_registry &get_registry()
+{
+    static flag_registry registry;
+    return registry;
+}
+
+} // namespace
+
+flag_id::flag_id( const std::string &name )
+{
+    flag_registry &registry = get_registry();
+    const auto iter = registry.indices.find( name );
+    if( iter != registry.indices.end() ) {
+        _index = iter->second;
+        return;
+    }
+    _index = registry.names.size();
+    registry.names.push_back( name );
+    registry.indices.emplace( name, _index );
+}
+
+const std::string &flag_id::str() const
+{
+    return get_registry().names[_index];
+}
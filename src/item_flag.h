@@ -0,0 +1,42 @@
+#ifndef ITEM_FLAG_H
+#define ITEM_FLAG_H
+
+#include <string>
+
+/**
+ * The name of an item flag (see @ref item::has_flag), interned to a small number.
+ *
+ * Item types keep their flags as bits indexed by that number (@ref itype::flag_bits),
+ * so checking a flag_id is a bit lookup instead of string comparisons. Flags stay plain
+ * strings in JSON, save games and Lua.
+ *
+ * Any string can be interned, the numbers are handed out in order of first use and are
+ * only valid during one run of the game. Interning looks up a hash map, so flags that are
+ * checked often should be kept in static constants:
+ * \code
+ * static const flag_id flag_WET( "WET" );
+ * if( it.has_flag( flag_WET ) ) { ...
+ * \endcode
+ */
+class flag_id
+{
+    public:
+        explicit flag_id( const std::string &name );
+
+        const std::string &str() const;
+        size_t index() const {
+            return _index;
+        }
+
+        bool operator==( const flag_id &rhs ) const {
+            return _index == rhs._index;
+        }
+        bool operator!=( const flag_id &rhs ) const {
+            return _index != rhs._index;
+        }
+
+    private:
+        size_t _index;
+};
+
+#endif
@@ -19,8 +19,10 @@ class item_stack
         virtual size_t size() const = 0;
         virtual bool empty() const = 0;
         virtual std::list<item>::iterator erase( std::list<item>::iterator it ) = 0;
+        /** Like the other erase, but the item is moved into removed instead of being destroyed. */
+        virtual std::list<item>::iterator erase( std::list<item>::iterator it, item &removed ) = 0;
         virtual void push_back( const item &newitem ) = 0;
-        virtual void insert_at( std::list<item>::iterator, const item &newitem ) = 0;
+        virtual void insert_at( std::list<item>::iterator, item newitem ) = 0;
         virtual item &front() = 0;
         virtual item &operator[]( size_t index ) = 0;
 };
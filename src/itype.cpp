@@ -14,6 +14,18 @@ std::string itype::nname( unsigned int const quantity ) const
     return ngettext( name.c_str(), name_plural.c_str(), quantity );
 }
 
+void itype::intern_flags()
+{
+    flag_bits.clear();
+    for( const auto &tag : item_tags ) {
+        const flag_id flag( tag );
+        if( flag.index() >= flag_bits.size() ) {
+            flag_bits.resize( flag.index() + 1 );
+        }
+        flag_bits[flag.index()] = true;
+    }
+}
+
 // Members of iuse struct, which is slowly morphing into a class.
 bool itype::has_use() const
 {
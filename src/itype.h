@@ -7,6 +7,7 @@
 #include "pldata.h" // add_type
 #include "bodypart.h" // body_part::num_bp
 #include "string_id.h"
+#include "item_flag.h"
 #include "explosion.h"
 #include "vitamin.h"
 
@@ -564,6 +565,11 @@ public:
     std::vector<use_function> use_methods; // Special effects of use
 
     std::set<std::string> item_tags;
+    /**
+     * @ref item_tags as bits, indexed by @ref flag_id::index. Filled by @ref intern_flags,
+     * which has to be called whenever item_tags changes.
+     */
+    std::vector<bool> flag_bits;
     std::set<matec_id> techniques;
 
     // Minimum stat(s) or skill(s) to use the item
@@ -677,6 +683,14 @@ public:
         return 1;
     }
 
+    /** Whether the flag is in @ref item_tags, see @ref flag_bits. */
+    bool has_flag( const flag_id &flag ) const
+    {
+        return flag.index() < flag_bits.size() && flag_bits[flag.index()];
+    }
+    /** Rebuilds @ref flag_bits from @ref item_tags. */
+    void intern_flags();
+
     bool has_use() const;
     bool can_use( const std::string &iuse_name ) const;
     const use_function *get_use( const std::string &iuse_name ) const;
@@ -1,5 +1,6 @@
 #include "json.h"
 
+#include <algorithm>
 #include <cmath> // pow
 #include <cstdlib> // strtoul
 #include <cstring> // strcmp
@@ -65,6 +66,16 @@ std::string utf16_to_utf8(uint32_t ch)
  * represents a JSON object,
  * providing access to the underlying data.
  */
+namespace {
+
+bool position_name_less( const std::pair<std::string, int> &a,
+                         const std::pair<std::string, int> &b )
+{
+    return a.first < b.first;
+}
+
+}
+
 JsonObject::JsonObject(JsonIn &j) : positions()
 {
     jsin = &j;
@@ -73,17 +84,28 @@ JsonObject::JsonObject(JsonIn &j) : positions()
     jsin->start_object();
     while (!jsin->end_object()) {
         std::string n = jsin->get_member_name();
-        int p = jsin->tell();
-        if (n != "//" && n != "comment" && positions.count(n) > 0) {
-            // members with name "//" or "comment" are used for comments and
-            // should be ignored anyway.
-            j.error("duplicate entry in json object");
-        }
-        positions[n] = p;
+        positions.emplace_back(std::move(n), jsin->tell());
         jsin->skip_value();
     }
     end = jsin->tell();
     final_separator = jsin->get_ate_separator();
+
+    // Stable, so that the later of two equally named members comes last.
+    std::stable_sort(positions.begin(), positions.end(), position_name_less);
+    for (size_t i = 1; i < positions.size(); ) {
+        if (positions[i].first != positions[i - 1].first) {
+            i++;
+            continue;
+        }
+        if (positions[i].first != "//" && positions[i].first != "comment") {
+            // members with name "//" or "comment" are used for comments and
+            // should be ignored anyway.
+            jsin->seek(positions[i].second);
+            jsin->error("duplicate entry in json object");
+        }
+        // Only the last one is accessible.
+        positions.erase(positions.begin() + i - 1);
+    }
 }
 
 JsonObject::JsonObject(const JsonObject &jo)
@@ -112,10 +134,22 @@ bool JsonObject::empty()
     return positions.empty();
 }
 
+int JsonObject::find_position(const std::string &name) const
+{
+    const auto iter = std::lower_bound(positions.begin(), positions.end(), name,
+    [](const std::pair<std::string, int> &a, const std::string &b) {
+        return a.first < b;
+    });
+    if (iter != positions.end() && iter->first == name) {
+        return iter->second;
+    }
+    return 0;
+}
+
 int JsonObject::verify_position(const std::string &name,
                                 const bool throw_exception)
 {
-    int pos = positions[name]; // initialized to 0 if it doesn't exist
+    int pos = find_position(name);
     if (pos > start) {
         return pos;
     } else if (throw_exception && !jsin) {
@@ -202,7 +236,7 @@ bool JsonObject::get_bool(const std::string &name)
 
 bool JsonObject::get_bool(const std::string &name, const bool fallback)
 {
-    int pos = positions[name];
+    int pos = find_position(name);
     if (pos <= start) {
         return fallback;
     }
@@ -219,7 +253,7 @@ int JsonObject::get_int(const std::string &name)
 
 int JsonObject::get_int(const std::string &name, const int fallback)
 {
-    int pos = positions[name];
+    int pos = find_position(name);
     if (pos <= start) {
         return fallback;
     }
@@ -236,7 +270,7 @@ long JsonObject::get_long(const std::string &name)
 
 long JsonObject::get_long(const std::string &name, const long fallback)
 {
-    long pos = positions[name];
+    long pos = find_position(name);
     if (pos <= start) {
         return fallback;
     }
@@ -253,7 +287,7 @@ double JsonObject::get_float(const std::string &name)
 
 double JsonObject::get_float(const std::string &name, const double fallback)
 {
-    int pos = positions[name];
+    int pos = find_position(name);
     if (pos <= start) {
         return fallback;
     }
@@ -270,7 +304,7 @@ std::string JsonObject::get_string(const std::string &name)
 
 std::string JsonObject::get_string(const std::string &name, const std::string &fallback)
 {
-    int pos = positions[name];
+    int pos = find_position(name);
     if (pos <= start) {
         return fallback;
     }
@@ -282,7 +316,7 @@ std::string JsonObject::get_string(const std::string &name, const std::string &f
 
 JsonArray JsonObject::get_array(const std::string &name)
 {
-    int pos = positions[name];
+    int pos = find_position(name);
     if (pos <= start) {
         return JsonArray(); // empty array
     }
@@ -312,7 +346,7 @@ std::vector<std::string> JsonObject::get_string_array(const std::string &name)
 
 JsonObject JsonObject::get_object(const std::string &name)
 {
-    int pos = positions[name];
+    int pos = find_position(name);
     if (pos <= start) {
         return JsonObject(); // empty object
     }
@@ -599,13 +599,19 @@ class JsonOut
 class JsonObject
 {
     private:
-        std::map<std::string, int> positions;
+        /**
+         * Position of the value of each member, sorted by name. A flat vector needs one
+         * allocation per object instead of one per member, and most objects are small.
+         */
+        std::vector<std::pair<std::string, int>> positions;
         int start;
         int end;
         bool final_separator;
         JsonIn *jsin;
         int verify_position(const std::string &name,
                             const bool throw_exception = true);
+        /** Position of the member's value, or 0 if there is no such member. */
+        int find_position(const std::string &name) const;
 
     public:
         JsonObject(JsonIn &jsin);
@@ -693,7 +699,7 @@ class JsonObject
         // return false if the member is not found.
         template <typename T> bool read(const std::string &name, T &t)
         {
-            int pos = positions[name];
+            int pos = find_position(name);
             if (pos <= start) {
                 return false;
             }
@@ -877,7 +883,7 @@ template <typename T>
 std::set<T> JsonObject::get_tags( const std::string &name )
 {
     std::set<T> res;
-    int pos = positions[ name ];
+    int pos = find_position( name );
     if ( pos <= start ) {
         return res;
     }
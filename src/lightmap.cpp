@@ -51,17 +51,23 @@ void map::build_transparency_cache( const int zlev )
     auto &transparency_cache = map_cache.transparency_cache;
     auto &outside_cache = map_cache.outside_cache;
 
-    if( !map_cache.transparency_cache_dirty ) {
+    if( map_cache.transparency_cache_dirty.none() ) {
         return;
     }
 
-    // Default to just barely not transparent.
-    std::uninitialized_fill_n(
-        &transparency_cache[0][0], MAPSIZE*SEEX * MAPSIZE*SEEY, LIGHT_TRANSPARENCY_OPEN_AIR);
+    if( map_cache.transparency_cache_dirty.all() ) {
+        // Default to just barely not transparent.
+        std::uninitialized_fill_n(
+            &transparency_cache[0][0], MAPSIZE*SEEX * MAPSIZE*SEEY, LIGHT_TRANSPARENCY_OPEN_AIR);
+    }
 
-    // Traverse the submaps in order
+    // Traverse the submaps in order, skipping the ones that didn't change
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
+                continue;
+            }
+
             auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
 
             for( int sx = 0; sx < SEEX; ++sx ) {
@@ -70,7 +76,8 @@ void map::build_transparency_cache( const int zlev )
                     const int y = sy + smy * SEEY;
 
                     auto &value = transparency_cache[x][y];
-
+                    // Default to just barely not transparent.
+                    value = LIGHT_TRANSPARENCY_OPEN_AIR;
                     if( !(cur_submap->ter[sx][sy].obj().transparent &&
                           cur_submap->frn[sx][sy].obj().transparent) ) {
                         value = LIGHT_TRANSPARENCY_SOLID;
@@ -125,7 +132,7 @@ void map::build_transparency_cache( const int zlev )
             }
         }
     }
-    map_cache.transparency_cache_dirty = false;
+    map_cache.transparency_cache_dirty.reset();
 }
 
 void map::apply_character_light( const player &p )
@@ -689,6 +696,26 @@ void cast_zlight(
  * @param starty the vertical component of the starting location
  * @param radius the maximum distance to draw the FOV
  */
+// Casts sight from ( x, y ) into all eight octants of a single z-level.
+static void cast_sight( float (&output_cache)[MAPSIZE*SEEX][MAPSIZE*SEEY],
+                        const float (&transparency_cache)[MAPSIZE*SEEX][MAPSIZE*SEEY],
+                        const int x, const int y )
+{
+    output_cache[x][y] = LIGHT_TRANSPARENCY_CLEAR;
+
+    castLight<0, 1, 1, 0, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+    castLight<1, 0, 0, 1, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+
+    castLight<0, -1, 1, 0, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+    castLight<-1, 0, 0, 1, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+
+    castLight<0, 1, -1, 0, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+    castLight<1, 0, 0, -1, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+
+    castLight<0, -1, -1, 0, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+    castLight<-1, 0, 0, -1, sight_calc, sight_check>( output_cache, transparency_cache, x, y, 0 );
+}
+
 void map::build_seen_cache( const tripoint &origin, const int target_z )
 {
     auto &map_cache = get_cache( target_z );
@@ -699,27 +726,7 @@ void map::build_seen_cache( const tripoint &origin, const int target_z )
         &seen_cache[0][0], MAPSIZE*SEEX * MAPSIZE*SEEY, LIGHT_TRANSPARENCY_SOLID);
 
     if( !fov_3d ) {
-        seen_cache[origin.x][origin.y] = LIGHT_TRANSPARENCY_CLEAR;
-
-        castLight<0, 1, 1, 0, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-        castLight<1, 0, 0, 1, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-
-        castLight<0, -1, 1, 0, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-        castLight<-1, 0, 0, 1, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-
-        castLight<0, 1, -1, 0, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-        castLight<1, 0, 0, -1, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-
-        castLight<0, -1, -1, 0, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
-        castLight<-1, 0, 0, -1, sight_calc, sight_check>(
-            seen_cache, transparency_cache, origin.x, origin.y, 0 );
+        cast_sight( seen_cache, transparency_cache, origin.x, origin.y );
     } else {
         if( origin.z == target_z ) {
             seen_cache[origin.x][origin.y] = LIGHT_TRANSPARENCY_CLEAR;
@@ -854,6 +861,37 @@ void map::build_seen_cache( const tripoint &origin, const int target_z )
     }
 }
 
+const std::bitset<MAPSIZE*SEEX * MAPSIZE*SEEY> &map::sight_cache( const tripoint &origin ) const
+{
+    // One bitmap is about 2 KB, clearing them all now and then is cheaper than tracking usage.
+    static const size_t max_sight_caches = 512;
+    const auto &map_cache = get_cache_ref( origin.z );
+    auto &sight_caches = map_cache.sight_caches;
+    const point key( origin.x, origin.y );
+    const auto iter = sight_caches.find( key );
+    if( iter != sight_caches.end() ) {
+        return iter->second;
+    }
+    if( sight_caches.size() >= max_sight_caches ) {
+        sight_caches.clear();
+    }
+
+    // Too large for the stack, and only ever used right here.
+    static float seen[MAPSIZE*SEEX][MAPSIZE*SEEY];
+    std::uninitialized_fill_n( &seen[0][0], MAPSIZE*SEEX * MAPSIZE*SEEY, LIGHT_TRANSPARENCY_SOLID );
+    cast_sight( seen, map_cache.transparency_cache, origin.x, origin.y );
+
+    auto &result = sight_caches[key];
+    for( int x = 0; x < MAPSIZE*SEEX; x++ ) {
+        for( int y = 0; y < MAPSIZE*SEEY; y++ ) {
+            if( seen[x][y] > LIGHT_TRANSPARENCY_SOLID ) {
+                result.set( x * MAPSIZE*SEEY + y );
+            }
+        }
+    }
+    return result;
+}
+
 template<int xx, int xy, int yx, int yy, float(*calc)(const float &, const float &, const int &),
          bool(*check)(const float &, const float &)>
 void castLight( float (&output_cache)[MAPSIZE*SEEX][MAPSIZE*SEEY],
@@ -862,7 +900,7 @@ void castLight( float (&output_cache)[MAPSIZE*SEEX][MAPSIZE*SEEY],
                 const int row, float start, const float end, double cumulative_transparency )
 {
     float newStart = 0.0f;
-    float radius = 60.0f - offsetDistance;
+    float radius = SHADOWCASTING_RADIUS - offsetDistance;
     if( start < end ) {
         return;
     }
@@ -10,6 +10,7 @@
 #include "color.h"
 #include "options.h"
 #include "debug.h"
+#include "init.h"
 #include "filesystem.h"
 #include "path_info.h"
 #include "mapsharing.h"
@@ -123,6 +124,15 @@ int main(int argc, char *argv[])
                     return 0;
                 }
             },
+            {
+                "--timing", nullptr,
+                "Writes how long loading and finalizing the game data takes to the debug log",
+                section_default,
+                [](int, const char **) -> int {
+                    DynamicDataLoader::get_instance().set_timing(true);
+                    return 0;
+                }
+            },
             {
                 "--basepath", "<path>",
                 "Base path for all game data subdirectories",
@@ -391,6 +401,7 @@ int main(int argc, char *argv[])
     set_escdelay(10); // Make escape actually responsive
 
     std::srand(seed);
+    rng_set_engine_seed(seed);
 
     g = new game;
     // First load and initialize everything that does not
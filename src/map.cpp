@@ -32,11 +32,13 @@
 #include "weather.h"
 #include "item_group.h"
 #include "pathfinding.h"
+#include "shadowcasting.h"
 
 #include <cmath>
 #include <stdlib.h>
 #include <fstream>
 #include <cstring>
+#include <algorithm>
 
 const mtype_id mon_spore( "mon_spore" );
 const mtype_id mon_zombie( "mon_zombie" );
@@ -86,15 +88,19 @@ std::list<item>::iterator map_stack::erase( std::list<item>::iterator it )
     return myorigin->i_rem(location, it);
 }
 
+std::list<item>::iterator map_stack::erase( std::list<item>::iterator it, item &removed )
+{
+    return myorigin->i_rem( location, it, removed );
+}
+
 void map_stack::push_back( const item &newitem )
 {
     myorigin->add_item_or_charges( location, newitem );
 }
 
-void map_stack::insert_at( std::list<item>::iterator index,
-                           const item &newitem )
+void map_stack::insert_at( std::list<item>::iterator index, item newitem )
 {
-    myorigin->add_item_at( location, index, newitem );
+    myorigin->add_item_at( location, index, std::move( newitem ) );
 }
 
 std::list<item>::iterator map_stack::begin()
@@ -337,7 +343,15 @@ void map::destroy_vehicle (vehicle *veh)
         if (current_submap->vehicles[i] == veh) {
             const int zlev = veh->smz;
             ch.vehicle_list.erase(veh);
+            unqueue_moving_vehicle( veh );
+            if( moving_vehicle == veh ) {
+                moving_vehicle = nullptr;
+            }
             reset_vehicle_cache( zlev );
+            // Vehicle parts are overlaid on top of the level caches
+            set_transparency_cache_dirty( zlev );
+            set_outside_cache_dirty( zlev );
+            set_floor_cache_dirty( zlev );
             current_submap->vehicles.erase (current_submap->vehicles.begin() + i);
             if( veh->tracking_on ) {
                 overmap_buffer.remove_vehicle( veh );
@@ -360,12 +374,17 @@ void map::on_vehicle_moved( const int smz ) {
 void map::vehmove()
 {
     // give vehicles movement points
-    {
-        VehicleList vehs = get_vehicles();
-        for( auto &vehs_v : vehs ) {
-            vehicle *veh = vehs_v.v;
+    vehicle_move_queue.clear();
+    moving_vehicle = nullptr;
+    const int zmin = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+    const int zmax = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    for( int z = zmin; z <= zmax; z++ ) {
+        for( vehicle *veh : get_cache( z ).vehicle_list ) {
             veh->gain_moves();
             veh->slow_leak();
+            if( veh->of_turn > 0 ) {
+                vehicle_move_queue.emplace( veh->of_turn, veh );
+            }
         }
     }
 
@@ -383,31 +402,81 @@ void map::vehmove()
         ( elem )->part_removal_cleanup();
     }
     dirty_vehicle_list.clear();
+    vehicle_move_queue.clear();
+    moving_vehicle = nullptr;
 }
 
-bool map::vehproceed()
+bool map::is_tracked_vehicle( const vehicle *veh ) const
 {
-    VehicleList vehs = get_vehicles();
-    vehicle* cur_veh = nullptr;
-    float max_of_turn = 0;
-    tripoint pt;
-    // First horizontal movement
-    for( auto &vehs_v : vehs ) {
-        if( vehs_v.v->of_turn > max_of_turn ) {
-            cur_veh = vehs_v.v;
-            pt = tripoint( vehs_v.x, vehs_v.y, vehs_v.z );
-            max_of_turn = cur_veh->of_turn;
+    const int zmin = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+    const int zmax = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    for( int z = zmin; z <= zmax; z++ ) {
+        // Only compares pointers, veh may already be gone.
+        if( get_cache_ref( z ).vehicle_list.count( const_cast<vehicle *>( veh ) ) > 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void map::unqueue_moving_vehicle( const vehicle *veh )
+{
+    for( auto it = vehicle_move_queue.begin(); it != vehicle_move_queue.end(); ++it ) {
+        if( it->second == veh ) {
+            vehicle_move_queue.erase( it );
+            return;
+        }
+    }
+}
+
+void map::set_vehicle_of_turn( vehicle &veh, const float of_turn )
+{
+    if( &veh == moving_vehicle ) {
+        // Not queued, next_moving_vehicle puts it back.
+        veh.of_turn = of_turn;
+        return;
+    }
+    unqueue_moving_vehicle( &veh );
+    veh.of_turn = of_turn;
+    if( of_turn > 0 && is_tracked_vehicle( &veh ) ) {
+        vehicle_move_queue.emplace( of_turn, &veh );
+    }
+}
+
+vehicle *map::next_moving_vehicle()
+{
+    if( moving_vehicle != nullptr && moving_vehicle->of_turn > 0 &&
+        is_tracked_vehicle( moving_vehicle ) ) {
+        vehicle_move_queue.emplace( moving_vehicle->of_turn, moving_vehicle );
+    }
+    moving_vehicle = nullptr;
+    while( !vehicle_move_queue.empty() ) {
+        vehicle *const veh = vehicle_move_queue.begin()->second;
+        vehicle_move_queue.erase( vehicle_move_queue.begin() );
+        // Vehicles that left the reality bubble (by shifting the map) stay behind.
+        if( is_tracked_vehicle( veh ) ) {
+            moving_vehicle = veh;
+            return veh;
         }
     }
+    return nullptr;
+}
+
+bool map::vehproceed()
+{
+    // First horizontal movement
+    vehicle *cur_veh = next_moving_vehicle();
 
     // Then vertical-only movement
     if( cur_veh == nullptr ) {
-        for( auto &vehs_v : vehs ) {
-            vehicle &cveh = *vehs_v.v;
-            if( cveh.falling ) {
-                cur_veh = vehs_v.v;
-                pt = tripoint( vehs_v.x, vehs_v.y, vehs_v.z );
-                break;
+        const int zmin = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+        const int zmax = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+        for( int z = zmin; z <= zmax && cur_veh == nullptr; z++ ) {
+            for( vehicle *veh : get_cache( z ).vehicle_list ) {
+                if( veh->falling ) {
+                    cur_veh = veh;
+                    break;
+                }
             }
         }
     }
@@ -417,6 +486,7 @@ bool map::vehproceed()
     }
 
     vehicle &veh = *cur_veh;
+    const tripoint pt = veh.global_pos3();
     if( !inbounds( pt ) ) {
         dbg( D_INFO ) << "stopping out-of-map vehicle. (x,y,z)=(" << pt.x << "," << pt.y << "," << pt.z << ")";
         veh.stop();
@@ -1032,7 +1102,8 @@ float map::vehicle_vehicle_collision( vehicle &veh, vehicle &veh2,
         }
 
         veh.of_turn = avg_of_turn * .9;
-        veh2.of_turn = avg_of_turn * 1.1;
+        // veh2 may be queued (or may now be able to move at all), requeue it.
+        set_vehicle_of_turn( veh2, avg_of_turn * 1.1 );
 
         //Energy after collision
         float E_a = 0.5 * m1 * final1.norm() * final1.norm() +
@@ -1405,6 +1476,10 @@ void map::displace_vehicle( tripoint &p, const tripoint &dp )
     veh->posx = dst_offset_x;
     veh->posy = dst_offset_y;
     veh->smz = p2.z;
+    if( src.z != p2.z ) {
+        get_cache( src.z ).vehicle_list.erase( veh );
+        get_cache( p2.z ).vehicle_list.insert( veh );
+    }
     // Invalidate vehicle's point cache
     veh->occupied_cache_turn = -1;
     if( src_submap != dst_submap ) {
@@ -1613,19 +1688,19 @@ void map::furn_set( const tripoint &p, const furn_id new_furniture )
     const furn_t &new_t = new_furniture.obj();
 
     if( old_t.transparent != new_t.transparent ) {
-        set_transparency_cache_dirty( p.z );
+        set_transparency_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_INDOORS ) != new_t.has_flag( TFLAG_INDOORS ) ) {
-        set_outside_cache_dirty( p.z );
+        set_outside_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_NO_FLOOR ) != new_t.has_flag( TFLAG_NO_FLOOR ) ) {
-        set_floor_cache_dirty( p.z );
+        set_floor_cache_dirty( p );
     }
 
     // @todo Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1825,21 +1900,24 @@ void map::ter_set( const tripoint &p, const ter_id new_terrain )
     }
 
     if( old_t.transparent != new_t.transparent ) {
-        set_transparency_cache_dirty( p.z );
+        set_transparency_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_INDOORS ) != new_t.has_flag( TFLAG_INDOORS ) ) {
-        set_outside_cache_dirty( p.z );
+        set_outside_cache_dirty( p );
+    }
+
+    if( new_t.has_flag( TFLAG_NO_FLOOR ) != old_t.has_flag( TFLAG_NO_FLOOR ) ) {
+        set_floor_cache_dirty( p );
     }
 
     if( new_t.has_flag( TFLAG_NO_FLOOR ) && !old_t.has_flag( TFLAG_NO_FLOOR ) ) {
-        set_floor_cache_dirty( p.z );
         // It's a set, not a flag
         support_cache_dirty.insert( p );
     }
 
     // @todo Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.x, p.y, p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -4447,6 +4525,13 @@ map_stack map::i_at( const tripoint &p )
 }
 
 std::list<item>::iterator map::i_rem( const tripoint &p, std::list<item>::iterator it )
+{
+    item discarded;
+    return i_rem( p, it, discarded );
+}
+
+std::list<item>::iterator map::i_rem( const tripoint &p, std::list<item>::iterator it,
+                                      item &removed )
 {
     int lx, ly;
     submap *const current_submap = get_submap_at( p, lx, ly );
@@ -4455,8 +4540,9 @@ std::list<item>::iterator map::i_rem( const tripoint &p, std::list<item>::iterat
         current_submap->active_items.remove( it, point( lx, ly ) );
     }
 
-    current_submap->update_lum_rem(*it, lx, ly);
+    current_submap->update_lum_rem( *it, lx, ly );
 
+    removed = std::move( *it );
     return current_submap->itm[lx][ly].erase( it );
 }
 
@@ -4718,8 +4804,9 @@ item &map::add_item_at( const tripoint &p,
     current_submap->is_uniform = false;
 
     current_submap->update_lum_add(new_item, lx, ly);
-    const auto new_pos = current_submap->itm[lx][ly].insert( index, new_item );
-    if( new_item.needs_processing() ) {
+    const auto new_pos = current_submap->itm[lx][ly].insert( index, std::move( new_item ) );
+    current_submap->mark_item_tile( lx, ly );
+    if( new_pos->needs_processing() ) {
         current_submap->active_items.add( new_pos, point(lx, ly) );
     }
 
@@ -4773,10 +4860,10 @@ static void apply_in_fridge(item &it)
 template <typename Iterator>
 static bool process_item( item_stack &items, Iterator &n, const tripoint &location, bool activate )
 {
-    // make a temporary copy, remove the item (in advance)
-    // and use that copy to process it
-    item temp_item = *n;
-    auto insertion_point = items.erase( n );
+    // remove the item (in advance) and process it outside of the stack,
+    // it's moved around, so this doesn't copy its contents, vars and tags
+    item temp_item;
+    auto insertion_point = items.erase( n, temp_item );
     if( !temp_item.process( nullptr, location, activate ) ) {
         // Not destroyed, must be inserted again.
         // If the item lost its active flag in processing,
@@ -4785,7 +4872,7 @@ static bool process_item( item_stack &items, Iterator &n, const tripoint &locati
         // This assumes that the item didn't invalidate any iterators
         // As a result of activation, because everything that does that
         // destroys itself.
-        items.insert_at( insertion_point, temp_item );
+        items.insert_at( insertion_point, std::move( temp_item ) );
         return false;
     }
     return true;
@@ -4858,7 +4945,7 @@ void map::process_items_in_submap( submap *const current_submap,
     // Get a COPY of the active item list for this submap.
     // If more are added as a side effect of processing, they are ignored this turn.
     // If they are destroyed before processing, they don't get processed.
-    std::list<item_reference> active_items = current_submap->active_items.get();
+    std::vector<item_reference> active_items = current_submap->active_items.get();
     auto const grid_offset = point {gridp.x * SEEX, gridp.y * SEEY};
     for( auto &active_item : active_items ) {
         if( !current_submap->active_items.has( active_item ) ) {
@@ -4987,6 +5074,51 @@ bool map::has_items( const tripoint &p ) const
     return !current_submap->itm[lx][ly].empty();
 }
 
+std::vector<tripoint> map::tiles_with_items( const tripoint &center, const int radius )
+{
+    std::vector<tripoint> result;
+    if( !inbounds( center ) ) {
+        return result;
+    }
+
+    const int minx = std::max( center.x - radius, 0 );
+    const int miny = std::max( center.y - radius, 0 );
+    const int maxx = std::min( center.x + radius, my_MAPSIZE * SEEX - 1 );
+    const int maxy = std::min( center.y + radius, my_MAPSIZE * SEEY - 1 );
+    for( int smx = minx / SEEX; smx <= maxx / SEEX; smx++ ) {
+        for( int smy = miny / SEEY; smy <= maxy / SEEY; smy++ ) {
+            submap *const current_submap = get_submap_at_grid( smx, smy, center.z );
+            auto &item_tiles = current_submap->item_tiles;
+            if( item_tiles.none() ) {
+                continue;
+            }
+            const int min_lx = std::max( minx - smx * SEEX, 0 );
+            const int min_ly = std::max( miny - smy * SEEY, 0 );
+            const int max_lx = std::min( maxx - smx * SEEX, SEEX - 1 );
+            const int max_ly = std::min( maxy - smy * SEEY, SEEY - 1 );
+            for( int lx = min_lx; lx <= max_lx; lx++ ) {
+                for( int ly = min_ly; ly <= max_ly; ly++ ) {
+                    const size_t i = lx * SEEY + ly;
+                    if( !item_tiles[i] ) {
+                        continue;
+                    }
+                    if( current_submap->itm[lx][ly].empty() ) {
+                        item_tiles.reset( i );
+                        continue;
+                    }
+                    result.emplace_back( smx * SEEX + lx, smy * SEEY + ly, center.z );
+                }
+            }
+        }
+    }
+
+    // Callers usually pick the first of several equally good tiles, keep that stable.
+    std::sort( result.begin(), result.end(), []( const tripoint &a, const tripoint &b ) {
+        return a.y < b.y || ( a.y == b.y && a.x < b.x );
+    } );
+    return result;
+}
+
 template <typename Stack>
 std::list<item> use_amount_stack( Stack stack, const itype_id type, long &quantity )
 {
@@ -5404,6 +5536,8 @@ void map::add_trap( const tripoint &p, const trap_id t)
     if( t != tr_null ) {
         traplocs[t].push_back( p );
     }
+
+    set_pathfinding_cache_dirty( p );
 }
 
 void map::disarm_trap( const tripoint &p )
@@ -5476,6 +5610,8 @@ void map::remove_trap( const tripoint &p )
         if( iter != traps.end() ) {
             traps.erase( iter );
         }
+
+        set_pathfinding_cache_dirty( p );
     }
 }
 /*
@@ -5596,21 +5732,31 @@ bool map::add_field(const tripoint &p, const field_id t, int density, const int
     submap *const current_submap = get_submap_at( p, lx, ly );
     current_submap->is_uniform = false;
 
-    if( current_submap->fld[lx][ly].addField( t, density, age ) ) {
+    field &fld = current_submap->fld[lx][ly];
+    const field_entry *const old_entry = fld.findField( t );
+    const int old_density = old_entry != nullptr ? old_entry->getFieldDensity() : 0;
+    if( fld.addField( t, density, age ) ) {
         //Only adding it to the count if it doesn't exist.
         current_submap->field_count++;
+        current_submap->mark_field_tile( lx, ly );
     }
+    const int new_density = fld.findField( t )->getFieldDensity();
 
     if( g != nullptr && this == &g->m && p == g->u.pos() ) {
         creature_in_field( g->u ); //Hit the player with the field if it spawned on top of them.
     }
 
-    // Dirty the transparency cache now that field processing doesn't always do it
-    // TODO: Make it skip transparent fields
-    set_transparency_cache_dirty( p.z );
+    // Field processing doesn't always dirty the transparency cache. Only fields that are not
+    // transparent at their density are in it, and how much light they let through depends on
+    // the density.
+    const auto &fdata = fieldlist[t];
+    if( new_density != old_density && ( !fdata.transparent[new_density - 1] ||
+                                        ( old_density > 0 && !fdata.transparent[old_density - 1] ) ) ) {
+        set_transparency_cache_dirty( p );
+    }
 
     if( field_type_dangerous( t ) ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     return true;
@@ -5631,14 +5777,14 @@ void map::remove_field( const tripoint &p, const field_id field_to_remove )
         const auto &fdata = fieldlist[ field_to_remove ];
         for( int i = 0; i < 3; ++i ) {
             if( !fdata.transparent[i] ) {
-                set_transparency_cache_dirty( p.z );
+                set_transparency_cache_dirty( p );
                 break;
             }
         }
 
         for( int i = 0; i < 3; ++i ) {
             if( fdata.dangerous[i] ) {
-                set_pathfinding_cache_dirty( p.z );
+                set_pathfinding_cache_dirty( p );
                 break;
             }
         }
@@ -6216,6 +6362,12 @@ void map::draw_from_above( WINDOW* w, player &u, const tripoint &p,
 
 bool map::sees( const tripoint &F, const tripoint &T, const int range ) const
 {
+    if( F.z == T.z && inbounds( F ) && rl_dist( F, T ) <= SHADOWCASTING_RADIUS ) {
+        if( ( range >= 0 && range < rl_dist( F, T ) ) || !inbounds( T ) ) {
+            return false; // Out of range!
+        }
+        return sight_cache( F )[T.x * MAPSIZE * SEEY + T.y];
+    }
     int dummy = 0;
     return sees( F, T, range, dummy );
 }
@@ -6511,6 +6663,8 @@ void map::shift( const int sx, const int sy )
     }
 
     shift_traps( tripoint( sx, sy, 0 ) );
+    // Fields are in local coordinates
+    distance_fields.clear();
 
     vehicle *remoteveh = g->remoteveh();
 
@@ -6706,12 +6860,46 @@ static void generate_uniform( const int x, const int y, const int z, const oter_
     }
 }
 
-void map::loadn( const int gridx, const int gridy, const int gridz, const bool update_vehicles )
+submap *map::load_or_generate_submap( const tripoint &p )
 {
     // Cache empty overmap types
     static const oter_id rock("empty_rock");
     static const oter_id air("open_air");
 
+    submap *result = MAPBUFFER.lookup_submap( p );
+    if( result != nullptr ) {
+        return result;
+    }
+    // It doesn't exist; we must generate it!
+    dbg( D_INFO | D_WARNING ) << "map::load_or_generate_submap: Missing mapbuffer data. Regenerating.";
+
+    // Each overmap square is two nonants; to prevent overlap, generate only at
+    //  squares divisible by 2.
+    const int newmapx = p.x - ( abs( p.x ) % 2 );
+    const int newmapy = p.y - ( abs( p.y ) % 2 );
+    // Short-circuit if the map tile is uniform
+    int overx = newmapx;
+    int overy = newmapy;
+    sm_to_omt( overx, overy );
+    oter_id terrain_type = overmap_buffer.ter( overx, overy, p.z );
+    if( terrain_type == rock || terrain_type == air ) {
+        generate_uniform( newmapx, newmapy, p.z, terrain_type );
+    } else {
+        tinymap tmp_map;
+        tmp_map.generate( newmapx, newmapy, p.z, calendar::turn );
+    }
+
+    // This is the same call to MAPBUFFER as above!
+    result = MAPBUFFER.lookup_submap( p );
+    if( result == nullptr ) {
+        dbg( D_ERROR ) << "failed to generate a submap at " << p.x << p.y << p.z;
+        debugmsg( "failed to generate a submap at %d,%d,%d", p.x, p.y, p.z );
+    }
+    return result;
+}
+
+void map::loadn( const int gridx, const int gridy, const int gridz, const bool update_vehicles )
+{
     dbg(D_INFO) << "map::loadn(game[" << g << "], worldx[" << abs_sub.x << "], worldy[" << abs_sub.y << "], gridx["
                 << gridx << "], gridy[" << gridy << "], gridz[" << gridz << "])";
 
@@ -6725,34 +6913,10 @@ void map::loadn( const int gridx, const int gridy, const int gridz, const bool u
     const int old_abs_z = abs_sub.z; // Ugly, but necessary at the moment
     abs_sub.z = gridz;
 
-    submap *tmpsub = MAPBUFFER.lookup_submap(absx, absy, gridz);
+    submap *tmpsub = load_or_generate_submap( tripoint( absx, absy, gridz ) );
     if( tmpsub == nullptr ) {
-        // It doesn't exist; we must generate it!
-        dbg( D_INFO | D_WARNING ) << "map::loadn: Missing mapbuffer data. Regenerating.";
-
-        // Each overmap square is two nonants; to prevent overlap, generate only at
-        //  squares divisible by 2.
-        const int newmapx = absx - ( abs( absx ) % 2 );
-        const int newmapy = absy - ( abs( absy ) % 2 );
-        // Short-circuit if the map tile is uniform
-        int overx = newmapx;
-        int overy = newmapy;
-        sm_to_omt( overx, overy );
-        oter_id terrain_type = overmap_buffer.ter( overx, overy, gridz );
-        if( terrain_type == rock || terrain_type == air ) {
-            generate_uniform( newmapx, newmapy, gridz, terrain_type );
-        } else {
-            tinymap tmp_map;
-            tmp_map.generate( newmapx, newmapy, gridz, calendar::turn );
-        }
-
-        // This is the same call to MAPBUFFER as above!
-        tmpsub = MAPBUFFER.lookup_submap( absx, absy, gridz );
-        if( tmpsub == nullptr ) {
-            dbg( D_ERROR ) << "failed to generate a submap at " << absx << absy << abs_sub.z;
-            debugmsg( "failed to generate a submap at %d,%d,%d", absx, absy, abs_sub.z );
-            return;
-        }
+        abs_sub.z = old_abs_z;
+        return;
     }
 
     // New submap changes the content of the map and all caches must be recalculated
@@ -7486,88 +7650,108 @@ long map::determine_wall_corner( const tripoint &p ) const
 void map::build_outside_cache( const int zlev )
 {
     auto &ch = get_cache( zlev );
-    if( !ch.outside_cache_dirty ) {
+    if( ch.outside_cache_dirty.none() ) {
         return;
     }
 
-    // Make a bigger cache to avoid bounds checking
-    // We will later copy it to our regular cache
-    const size_t padded_w = ( MAPSIZE * SEEX ) + 2;
-    const size_t padded_h = ( MAPSIZE * SEEY ) + 2;
-    bool padded_cache[padded_w][padded_h];
-
     auto &outside_cache = ch.outside_cache;
     if( zlev < 0 )
     {
         std::uninitialized_fill_n(
             &outside_cache[0][0], ( MAPSIZE * SEEX ) * ( MAPSIZE * SEEY ), false );
+        ch.outside_cache_dirty.reset();
         return;
     }
 
-    std::uninitialized_fill_n(
-            &padded_cache[0][0], padded_w * padded_h, true );
+    // Whether the tile blocks the sky for itself and its neighbors.
+    // Out of bounds tiles are treated as open air.
+    const auto is_indoors = [this, zlev]( const int x, const int y ) {
+        if( x < 0 || y < 0 || x >= my_MAPSIZE * SEEX || y >= my_MAPSIZE * SEEY ) {
+            return false;
+        }
+        auto const cur_submap = get_submap_at_grid( x / SEEX, y / SEEY, zlev );
+        const int sx = x % SEEX;
+        const int sy = y % SEEY;
+        return cur_submap->get_ter( sx, sy ).obj().has_flag( TFLAG_INDOORS ) ||
+               cur_submap->get_furn( sx, sy ).obj().has_flag( TFLAG_INDOORS );
+    };
+
+    // Make a bigger cache to avoid bounds checking when spreading the indoor flag.
+    // It covers a single submap plus a one tile border from its neighbors.
+    const int padded_w = SEEX + 2;
+    const int padded_h = SEEY + 2;
+    bool padded_indoors[padded_w][padded_h];
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
+            const size_t smn = smx * MAPSIZE + smy;
+            if( !ch.outside_cache_dirty[smn] ) {
+                continue;
+            }
+
+            for( int px = 0; px < padded_w; px++ ) {
+                for( int py = 0; py < padded_h; py++ ) {
+                    padded_indoors[px][py] = is_indoors( smx * SEEX + px - 1, smy * SEEY + py - 1 );
+                }
+            }
 
             for( int sx = 0; sx < SEEX; ++sx ) {
                 for( int sy = 0; sy < SEEY; ++sy ) {
-                    if( cur_submap->get_ter( sx, sy ).obj().has_flag( TFLAG_INDOORS ) ||
-                        cur_submap->get_furn( sx, sy ).obj().has_flag( TFLAG_INDOORS ) ) {
-                        const int x = sx + ( smx * SEEX );
-                        const int y = sy + ( smy * SEEY );
-                        // Add 1 to both coords, because we're operating on the padded cache
-                        for( int dx = 0; dx <= 2; dx++ )
-                        {
-                            for( int dy = 0; dy <= 2; dy++ )
-                            {
-                                padded_cache[x + dx][y + dy] = false;
+                    // Add 1 to both coords, because we're operating on the padded cache
+                    bool outside = true;
+                    for( int dx = 0; dx <= 2 && outside; dx++ ) {
+                        for( int dy = 0; dy <= 2; dy++ ) {
+                            if( padded_indoors[sx + dx][sy + dy] ) {
+                                outside = false;
+                                break;
                             }
                         }
                     }
+                    outside_cache[sx + smx * SEEX][sy + smy * SEEY] = outside;
                 }
             }
-        }
-    }
 
-    // Copy the padded cache back to the proper one, but with no padding
-    for( int x = 0; x < my_MAPSIZE * SEEX; x++ ) {
-        std::copy_n( &padded_cache[x + 1][1], my_MAPSIZE * SEEX, &outside_cache[x][0] );
+            // Transparency depends on being outside (weather sight penalty)
+            ch.transparency_cache_dirty.set( smn );
+        }
     }
 
-    ch.outside_cache_dirty = false;
+    ch.outside_cache_dirty.reset();
 }
 
 void map::build_floor_cache( const int zlev )
 {
     auto &ch = get_cache( zlev );
-    if( !ch.floor_cache_dirty ) {
+    if( ch.floor_cache_dirty.none() ) {
         return;
     }
 
     auto &floor_cache = ch.floor_cache;
-    std::uninitialized_fill_n(
+    if( ch.floor_cache_dirty.all() ) {
+        std::uninitialized_fill_n(
             &floor_cache[0][0], ( MAPSIZE * SEEX ) * ( MAPSIZE * SEEY ), true );
+    }
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !ch.floor_cache_dirty[smx * MAPSIZE + smy] ) {
+                continue;
+            }
+
             auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
 
             for( int sx = 0; sx < SEEX; ++sx ) {
                 for( int sy = 0; sy < SEEY; ++sy ) {
                     // Note: furniture currently can't affect existence of floor
-                    if( cur_submap->get_ter( sx, sy ).obj().has_flag( TFLAG_NO_FLOOR ) ) {
-                        const int x = sx + ( smx * SEEX );
-                        const int y = sy + ( smy * SEEY );
-                        floor_cache[x][y] = false;
-                    }
+                    const int x = sx + ( smx * SEEX );
+                    const int y = sy + ( smy * SEEY );
+                    floor_cache[x][y] = !cur_submap->get_ter( sx, sy ).obj().has_flag( TFLAG_NO_FLOOR );
                 }
             }
         }
     }
 
-    ch.floor_cache_dirty = false;
+    ch.floor_cache_dirty.reset();
 }
 
 void map::build_floor_caches()
@@ -7587,6 +7771,8 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
         build_outside_cache( z );
         build_transparency_cache( z );
         build_floor_cache( z );
+        // Vehicles (below) change the transparency without dirtying it.
+        get_cache( z ).sight_caches.clear();
     }
 
     tripoint start( 0, 0, minz );
@@ -8203,15 +8389,17 @@ const level_cache &map::access_cache( int zlev ) const
 
 level_cache::level_cache()
 {
-    transparency_cache_dirty = true;
-    outside_cache_dirty = true;
+    transparency_cache_dirty.set();
+    outside_cache_dirty.set();
+    floor_cache_dirty.set();
     veh_in_active_range = false;
     std::fill_n( &veh_exists_at[0][0], SEEX * MAPSIZE * SEEY * MAPSIZE, false );
 }
 
 pathfinding_cache::pathfinding_cache()
 {
-    dirty = true;
+    dirty.set();
+    clusters_dirty.set();
 }
 
 pathfinding_cache::~pathfinding_cache()
@@ -8224,7 +8412,47 @@ pathfinding_cache &map::get_pathfinding_cache( int zlev ) const {
 
 void map::set_pathfinding_cache_dirty( const int zlev ) {
     if( inbounds_z( zlev ) ) {
-        get_pathfinding_cache( zlev ).dirty = true;
+        get_pathfinding_cache( zlev ).dirty.set();
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    if( inbounds( p ) ) {
+        get_pathfinding_cache( p.z ).dirty.set( ( p.x / SEEX ) * MAPSIZE + p.y / SEEY );
+    }
+}
+
+void map::set_transparency_cache_dirty( const tripoint &p )
+{
+    if( inbounds( p ) ) {
+        get_cache( p.z ).transparency_cache_dirty.set( ( p.x / SEEX ) * MAPSIZE + p.y / SEEY );
+    }
+}
+
+void map::set_outside_cache_dirty( const tripoint &p )
+{
+    if( !inbounds( p ) ) {
+        return;
+    }
+
+    // Indoor tiles make their neighbors "not outside" too, see build_outside_cache
+    auto &dirty = get_cache( p.z ).outside_cache_dirty;
+    const int min_smx = std::max( p.x - 1, 0 ) / SEEX;
+    const int min_smy = std::max( p.y - 1, 0 ) / SEEY;
+    const int max_smx = std::min( p.x + 1, my_MAPSIZE * SEEX - 1 ) / SEEX;
+    const int max_smy = std::min( p.y + 1, my_MAPSIZE * SEEY - 1 ) / SEEY;
+    for( int smx = min_smx; smx <= max_smx; smx++ ) {
+        for( int smy = min_smy; smy <= max_smy; smy++ ) {
+            dirty.set( smx * MAPSIZE + smy );
+        }
+    }
+}
+
+void map::set_floor_cache_dirty( const tripoint &p )
+{
+    if( inbounds( p ) ) {
+        get_cache( p.z ).floor_cache_dirty.set( ( p.x / SEEX ) * MAPSIZE + p.y / SEEY );
     }
 }
 
@@ -8235,7 +8463,7 @@ const pathfinding_cache &map::get_pathfinding_cache_ref( int zlev ) const
         return *pathfinding_caches[ OVERMAP_DEPTH ];
     }
     auto &cache = get_pathfinding_cache( zlev );
-    if( cache.dirty ) {
+    if( cache.dirty.any() ) {
         update_pathfinding_cache( zlev );
     }
 
@@ -8245,14 +8473,35 @@ const pathfinding_cache &map::get_pathfinding_cache_ref( int zlev ) const
 void map::update_pathfinding_cache( int zlev ) const
 {
     auto &cache = get_pathfinding_cache( zlev );
-    if( !cache.dirty ) {
+    if( cache.dirty.none() ) {
         return;
     }
 
-    std::uninitialized_fill_n( &cache.special[0][0], MAPSIZE*SEEX * MAPSIZE*SEEY, PF_NORMAL );
+    if( cache.dirty.all() ) {
+        std::uninitialized_fill_n( &cache.special[0][0], MAPSIZE*SEEX * MAPSIZE*SEEY, PF_NORMAL );
+    }
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !cache.dirty[smx * MAPSIZE + smy] ) {
+                continue;
+            }
+
+            // Entrances on the shared edges depend on both submaps
+            cache.clusters_dirty.set( smx * MAPSIZE + smy );
+            if( smx > 0 ) {
+                cache.clusters_dirty.set( ( smx - 1 ) * MAPSIZE + smy );
+            }
+            if( smx + 1 < my_MAPSIZE ) {
+                cache.clusters_dirty.set( ( smx + 1 ) * MAPSIZE + smy );
+            }
+            if( smy > 0 ) {
+                cache.clusters_dirty.set( smx * MAPSIZE + smy - 1 );
+            }
+            if( smy + 1 < my_MAPSIZE ) {
+                cache.clusters_dirty.set( smx * MAPSIZE + smy + 1 );
+            }
+
             auto const cur_submap = get_submap_at_grid( smx, smy, zlev );
 
             tripoint p( 0, 0, zlev );
@@ -8277,6 +8526,18 @@ void map::update_pathfinding_cache( int zlev ) const
                         cur_value |= PF_SLOW;
                     } else if( cost <= 0 ) {
                         cur_value |= PF_WALL;
+                        // Same doors as route_flat opens, except the ones that only open from inside
+                        if( terrain.open ) {
+                            if( !terrain.has_flag( "OPENCLOSE_INSIDE" ) ) {
+                                cur_value |= PF_DOOR;
+                            }
+                        } else if( veh != nullptr ) {
+                            const int obstacle = veh->obstacle_at_part( part );
+                            if( obstacle >= 0 && veh->part_flag( obstacle, VPFLAG_OPENABLE ) &&
+                                !veh->part_flag( obstacle, "OPENCLOSE_INSIDE" ) ) {
+                                cur_value |= PF_DOOR;
+                            }
+                        }
                     }
 
                     if( veh != nullptr ) {
@@ -8307,7 +8568,7 @@ void map::update_pathfinding_cache( int zlev ) const
         }
     }
 
-    cache.dirty = false;
+    cache.dirty.reset();
 }
 
 void map::clip_to_bounds( tripoint &p ) const
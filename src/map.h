@@ -6,6 +6,8 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <bitset>
+#include <functional>
 
 #include "game_constants.h"
 #include "item.h"
@@ -89,8 +91,9 @@ public:
     size_t size() const override;
     bool empty() const override;
     std::list<item>::iterator erase( std::list<item>::iterator it ) override;
+    std::list<item>::iterator erase( std::list<item>::iterator it, item &removed ) override;
     void push_back( const item &newitem ) override;
-    void insert_at( std::list<item>::iterator index, const item &newitem ) override;
+    void insert_at( std::list<item>::iterator index, item newitem ) override;
     std::list<item>::iterator begin();
     std::list<item>::iterator end();
     std::list<item>::const_iterator begin() const;
@@ -137,9 +140,16 @@ struct level_cache {
     level_cache(); // Zeroes all relevant values
     level_cache( const level_cache &other ) = default;
 
-    bool transparency_cache_dirty;
-    bool outside_cache_dirty;
-    bool floor_cache_dirty;
+    /**
+     * Per-submap dirty flags, one bit per submap of the level, indexed by
+     * `gridx * MAPSIZE + gridy`. Only the submaps with their bit set are
+     * recalculated by the corresponding build_*_cache function.
+     */
+    /*@{*/
+    std::bitset<MAPSIZE * MAPSIZE> transparency_cache_dirty;
+    std::bitset<MAPSIZE * MAPSIZE> outside_cache_dirty;
+    std::bitset<MAPSIZE * MAPSIZE> floor_cache_dirty;
+    /*@}*/
 
     float lm[MAPSIZE*SEEX][MAPSIZE*SEEY];
     float sm[MAPSIZE*SEEX][MAPSIZE*SEEY];
@@ -156,6 +166,12 @@ struct level_cache {
     bool veh_exists_at[SEEX * MAPSIZE][SEEY * MAPSIZE];
     std::map< tripoint, std::pair<vehicle*,int> > veh_cached_parts;
     std::set<vehicle*> vehicle_list;
+
+    /**
+     * Tiles seen from observer positions on this level, see map::sight_cache.
+     * Cleared whenever the transparency cache is (re)built.
+     */
+    mutable std::map<point, std::bitset<MAPSIZE*SEEX * MAPSIZE*SEEY>> sight_caches;
 };
 
 /**
@@ -207,25 +223,38 @@ class map
     /*@{*/
     void set_transparency_cache_dirty( const int zlev ) {
         if( inbounds_z( zlev ) ) {
-            get_cache( zlev ).transparency_cache_dirty = true;
+            get_cache( zlev ).transparency_cache_dirty.set();
+            get_cache( zlev ).sight_caches.clear();
         }
     }
 
     void set_outside_cache_dirty( const int zlev ) {
         if( inbounds_z( zlev ) ) {
-            get_cache( zlev ).outside_cache_dirty = true;
+            get_cache( zlev ).outside_cache_dirty.set();
         }
     }
 
     void set_floor_cache_dirty( const int zlev ) {
         if( inbounds_z( zlev ) ) {
-            get_cache( zlev ).floor_cache_dirty = true;
+            get_cache( zlev ).floor_cache_dirty.set();
         }
     }
 
     void set_pathfinding_cache_dirty( const int zlev );
     /*@}*/
 
+    /**
+     * Like the above, but only mark the submap containing the given point as dirty.
+     * Changes to the outside cache also bleed into the neighboring tiles,
+     * so those mark every submap touched by the 3x3 area around the point.
+     */
+    /*@{*/
+    void set_transparency_cache_dirty( const tripoint &p );
+    void set_outside_cache_dirty( const tripoint &p );
+    void set_floor_cache_dirty( const tripoint &p );
+    void set_pathfinding_cache_dirty( const tripoint &p );
+    /*@}*/
+
 
     /**
      * Callback invoked when a vehicle has moved.
@@ -295,6 +324,13 @@ class map
      * @param update_vehicles If true, add vehicles to the vehicle cache.
      */
     void load(const int wx, const int wy, const int wz, const bool update_vehicles);
+    /**
+     * Get the submap at the absolute submap position p from the @ref mapbuffer,
+     * generating the overmap terrain tile that contains it if it doesn't exist yet.
+     * The submap is not added to any map.
+     * @return nullptr if generating failed.
+     */
+    static submap *load_or_generate_submap( const tripoint &p );
     /**
      * Shift the map along the vector (sx,sy).
      * This is like loading the map with coordinates derived from the current
@@ -388,6 +424,13 @@ public:
      * Set to zero if the function returns false.
     **/
     bool sees( const tripoint &F, const tripoint &T, int range, int &bresenham_slope ) const;
+    /**
+     * Shadowcast visibility from origin on its own z-level, one bit per tile, indexed
+     * by `x * MAPSIZE * SEEY + y`. It's built on the first call for a position and
+     * reused until the next @ref build_map_cache, so repeated @ref sees calls of an
+     * observer are bit lookups instead of Bresenham lines.
+     */
+    const std::bitset<MAPSIZE*SEEX * MAPSIZE*SEEY> &sight_cache( const tripoint &origin ) const;
  public:
     /**
      * Check whether there's a direct line of sight between `F` and
@@ -434,6 +477,9 @@ public:
     /**
      * Calculate a best path using A*
      *
+     * Long routes on a single z-level are first planned between submap entrances
+     * and only then refined to single tiles, see @ref route_hierarchical.
+     *
      * @param f The source location from which to path.
      * @param t The destination to which to path.
      * @param bash Bashing strength of pathing creature (0 means no bashing through terrain).
@@ -445,6 +491,15 @@ public:
     std::vector<tripoint> route( const tripoint &f, const tripoint &t,
                                  const int bash, const int maxdist ) const;
 
+    /**
+     * Walking costs from every tile on the z-level of target to target.
+     * The field is calculated on first use and reused by all callers for the rest
+     * of the turn or until the target moves, so that a crowd of monsters
+     * chasing the same creature shares a single search.
+     * Tiles farther than a limited walking cost from the target are left unknown.
+     */
+    const distance_field &get_distance_field( const tripoint &target ) const;
+
  int coord_to_angle(const int x, const int y, const int tgtx, const int tgty) const;
 // Vehicles: Common to 2D and 3D
     VehicleList get_vehicles();
@@ -599,6 +654,12 @@ public:
      * Checks for existence of items. Faster than i_at(p).empty
      */
     bool has_items( const tripoint &p ) const;
+    /**
+     * Returns the tiles within radius of center (on its z-level) that have items,
+     * in the same order as @ref points_in_radius. Only the tiles marked in
+     * submap::item_tiles are looked at, so this doesn't scan the whole area.
+     */
+    std::vector<tripoint> tiles_with_items( const tripoint &center, int radius );
 
 // Flags: 2D overloads
     std::string features(const int x, const int y); // Words relevant to terrain (sharp, etc)
@@ -811,6 +872,9 @@ void add_corpse( const tripoint &p );
     // i_rem() methods that return values act like container::erase(),
     // returning an iterator to the next item after removal.
     std::list<item>::iterator i_rem( const tripoint &p, std::list<item>::iterator it );
+    // Like the above, but moves the item into removed instead of destroying it.
+    std::list<item>::iterator i_rem( const tripoint &p, std::list<item>::iterator it,
+                                     item &removed );
     int i_rem( const tripoint &p, const int index );
     void i_rem( const tripoint &p, const item* it );
     void spawn_artifact( const tripoint &p );
@@ -898,8 +962,12 @@ void add_corpse( const tripoint &p );
  void remove_trap( const tripoint &p );
  const std::vector<tripoint> &trap_locations(trap_id t) const;
 
+ /**
+  * Processes the fields of all submaps that have some.
+  * @return Whether the transparency of any tile changed.
+  */
  bool process_fields(); // See fields.cpp
- bool process_fields_in_submap( submap * const current_submap,
+ void process_fields_in_submap( submap * const current_submap,
                                 const int submap_x, const int submap_y, const int submap_z); // See fields.cpp
         /**
          * Apply field effects to the creature when it's on a square with fields.
@@ -1412,7 +1480,32 @@ private:
      */
     std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
+    /**
+     * Vehicles that may still move this turn, highest @ref vehicle::of_turn first.
+     * Filled by @ref vehmove from the vehicle lists in the level caches, so that
+     * @ref vehproceed doesn't have to look at every vehicle in the reality bubble.
+     * The vehicle that is moving (@ref moving_vehicle) is taken out while it changes,
+     * the of_turn of other vehicles must only be changed by @ref set_vehicle_of_turn.
+     */
+    std::set< std::pair<float, vehicle *>, std::greater< std::pair<float, vehicle *> > > vehicle_move_queue;
+    /** The vehicle the last call to @ref vehproceed moved, or nullptr if it has been destroyed. */
+    vehicle *moving_vehicle = nullptr;
+    /**
+     * Puts @ref moving_vehicle back into @ref vehicle_move_queue if it can still move
+     * and takes the next vehicle from the queue.
+     * @return nullptr if no vehicle has moves left.
+     */
+    vehicle *next_moving_vehicle();
+    /** Sets the of_turn of a vehicle and (re)queues it in @ref vehicle_move_queue. */
+    void set_vehicle_of_turn( vehicle &veh, float of_turn );
+    /** Removes the vehicle from @ref vehicle_move_queue, whatever its of_turn is now. */
+    void unqueue_moving_vehicle( const vehicle *veh );
+    /** Whether the vehicle is in the vehicle list of any level cache. */
+    bool is_tracked_vehicle( const vehicle *veh ) const;
+
     mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+    /** Recently used distance fields, see @ref get_distance_field. */
+    mutable std::vector< std::unique_ptr<distance_field> > distance_fields;
 
     // Note: no bounds check
     level_cache &get_cache( int zlev ) {
@@ -1421,6 +1514,25 @@ private:
 
     pathfinding_cache &get_pathfinding_cache( int zlev ) const;
 
+    /**
+     * Plain A* over the tiles around f and t, see @ref route.
+     */
+    std::vector<tripoint> route_flat( const tripoint &f, const tripoint &t,
+                                      const int bash, const int maxdist,
+                                      const std::set<tripoint> &pre_closed ) const;
+    /**
+     * Finds a path through the submap entrances in @ref pathfinding_cache::clusters,
+     * then refines it into a tile path with @ref route_flat.
+     * Only works within one z-level. Returns an empty route if no path was found this way
+     * (or, for bashers, only a long detour), in which case the caller should fall back
+     * to @ref route_flat.
+     */
+    std::vector<tripoint> route_hierarchical( const tripoint &f, const tripoint &t,
+                                              const int bash, const int maxdist,
+                                              const std::set<tripoint> &pre_closed ) const;
+    /** Rebuilds the entries of @ref pathfinding_cache::clusters marked as dirty. */
+    void update_pathfinding_clusters( int zlev ) const;
+
     visibility_variables visibility_variables_cache;
 
   public:
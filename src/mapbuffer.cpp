@@ -14,9 +14,13 @@
 #include "trap.h"
 #include "vehicle.h"
 #include "submap.h"
+#include "options.h"
 
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <sstream>
+#include <unordered_map>
 
 #define dbg(x) DebugLog((DebugLevel)(x),D_MAP) << __FILE__ << ":" << __LINE__ << ": "
 
@@ -33,6 +37,8 @@ mapbuffer::~mapbuffer()
 
 void mapbuffer::reset()
 {
+    flush();
+    io.clear_staged();
     for( auto &elem : submaps ) {
         delete elem.second;
     }
@@ -102,6 +108,8 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
 
 void mapbuffer::save( bool delete_after_save )
 {
+    report_failed_writes();
+
     std::stringstream map_directory;
     map_directory << world_generator->active_world->world_path << "/maps";
     assure_dir_exist( map_directory.str().c_str() );
@@ -141,7 +149,7 @@ void mapbuffer::save( bool delete_after_save )
 
         std::stringstream quad_path;
         quad_path << dirname.str() << "/" << om_addr.x << "." <<
-                  om_addr.y << "." << om_addr.z << ".map";
+                  om_addr.y << "." << om_addr.z;
 
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
@@ -158,6 +166,492 @@ void mapbuffer::save( bool delete_after_save )
     }
 }
 
+namespace {
+
+/**
+ * Layout of the binary quad files (all values in the byte order of the machine that wrote them):
+ * - header: magic, @ref binary_map_version, byte order mark, savegame version
+ * - palettes of terrain, furniture and trap string ids, each a count followed by
+ *   length-prefixed strings; the arrays below store indices into them
+ * - number of submaps, followed by each submap:
+ *   - coordinates, turn_last_touched, temperature
+ *   - fixed size arrays (SEEX * SEEY entries, indexed x * SEEY + y) of terrain, furniture,
+ *     traps, radiation and luminance
+ *   - number of tagged sections, each a tag, its length in bytes and the data. Everything
+ *     else (items, vehicles, fields, ...) goes into a JSON object in the @ref json_section.
+ * Unknown sections are skipped, everything else must match exactly or the file is rejected.
+ */
+const char binary_map_magic[8] = { 'C', 'D', 'D', 'A', 'Q', 'U', 'A', 'D' };
+const uint32_t binary_map_version = 1;
+const uint32_t binary_map_byte_order = 0x01020304;
+const uint32_t json_section = 0x4e4f534a; // "JSON"
+
+const std::string json_map_extension = ".map";
+const std::string binary_map_extension = ".bmap";
+
+/** Path of the file of the quad at om_addr, without the extension. */
+std::string quad_file_path( const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    std::stringstream quad_path;
+    quad_path << world_generator->active_world->world_path << "/maps/" <<
+              segment_addr.x << "." << segment_addr.y << "." << segment_addr.z << "/" <<
+              om_addr.x << "." << om_addr.y << "." << om_addr.z;
+    return quad_path.str();
+}
+
+class binary_writer
+{
+    public:
+        binary_writer( std::ostream &out ) : out( out ) { }
+
+        template<typename T>
+        void write( const T &value ) {
+            out.write( reinterpret_cast<const char *>( &value ), sizeof( value ) );
+        }
+        void write( const std::string &value ) {
+            write<uint32_t>( value.size() );
+            out.write( value.data(), value.size() );
+        }
+
+    private:
+        std::ostream &out;
+};
+
+class binary_reader
+{
+    public:
+        binary_reader( const char *data, size_t size ) : pos( data ), end( data + size ) { }
+
+        template<typename T>
+        T read() {
+            T value;
+            std::memcpy( &value, get( sizeof( value ) ), sizeof( value ) );
+            return value;
+        }
+        std::string read_string() {
+            const uint32_t size = read<uint32_t>();
+            return std::string( get( size ), size );
+        }
+        /** Returns a pointer to the next @p size bytes and skips them. */
+        const char *get( size_t size ) {
+            if( size > static_cast<size_t>( end - pos ) ) {
+                throw std::runtime_error( "unexpected end of file" );
+            }
+            const char *const result = pos;
+            pos += size;
+            return result;
+        }
+
+    private:
+        const char *pos;
+        const char *const end;
+};
+
+/** Maps the ids used in a quad to consecutive indices, which are stored instead of the ids. */
+class binary_palette
+{
+    public:
+        uint16_t index_of( const int id, const std::string &str ) {
+            const auto iter = indices.find( id );
+            if( iter != indices.end() ) {
+                return iter->second;
+            }
+            const uint16_t result = ids.size();
+            ids.push_back( str );
+            indices.emplace( id, result );
+            return result;
+        }
+        void write( binary_writer &out ) const {
+            out.write<uint32_t>( ids.size() );
+            for( const auto &id : ids ) {
+                out.write( id );
+            }
+        }
+
+    private:
+        std::unordered_map<int, uint16_t> indices;
+        std::vector<std::string> ids;
+};
+
+template<typename T>
+std::vector<T> read_palette( binary_reader &in, const std::function<T( const std::string & )> &convert )
+{
+    std::vector<T> result;
+    const uint32_t count = in.read<uint32_t>();
+    for( uint32_t i = 0; i < count; i++ ) {
+        result.push_back( convert( in.read_string() ) );
+    }
+    return result;
+}
+
+template<typename T>
+void read_palette_array( binary_reader &in, const std::vector<T> &palette, T ( &array )[SEEX][SEEY] )
+{
+    for( int i = 0; i < SEEX; i++ ) {
+        for( int j = 0; j < SEEY; j++ ) {
+            array[i][j] = palette.at( in.read<uint16_t>() );
+        }
+    }
+}
+
+/**
+ * Writes everything that isn't stored in fixed size arrays (see @ref save_submap_arrays).
+ */
+void save_submap_contents( JsonOut &jsout, const submap &sm )
+{
+    jsout.member( "items" );
+    jsout.start_array();
+    for(int j = 0; j < SEEY; j++) {
+        for(int i = 0; i < SEEX; i++) {
+            if( sm.itm[i][j].empty() ) {
+                continue;
+            }
+            jsout.write( i );
+            jsout.write( j );
+            jsout.write( sm.itm[i][j] );
+        }
+    }
+    jsout.end_array();
+
+    jsout.member( "fields" );
+    jsout.start_array();
+    for(int j = 0; j < SEEY; j++) {
+        for(int i = 0; i < SEEX; i++) {
+            // Save fields
+            if (sm.fld[i][j].fieldCount() > 0) {
+                jsout.write( i );
+                jsout.write( j );
+                jsout.start_array();
+                for( auto &fld : sm.fld[i][j] ) {
+                    const field_entry &cur = fld.second;
+                        // We don't seem to have a string identifier for fields anywhere.
+                        jsout.write( cur.getFieldType() );
+                        jsout.write( cur.getFieldDensity() );
+                        jsout.write( cur.getFieldAge() );
+                }
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+
+    jsout.member("cosmetics");
+    jsout.start_array();
+    for (int j = 0; j < SEEY; j++) {
+        for (int i = 0; i < SEEX; i++) {
+            if (sm.cosmetics[i][j].size() > 0) {
+                jsout.start_array();
+                jsout.write(i);
+                jsout.write(j);
+                jsout.write(sm.cosmetics[i][j]);
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+
+    // Output the spawn points
+    jsout.member( "spawns" );
+    jsout.start_array();
+    for( auto &elem : sm.spawns ) {
+        jsout.start_array();
+        jsout.write( elem.type.str() ); // TODO: json should know how to write string_ids
+        jsout.write( elem.count );
+        jsout.write( elem.posx );
+        jsout.write( elem.posy );
+        jsout.write( elem.faction_id );
+        jsout.write( elem.mission_id );
+        jsout.write( elem.friendly );
+        jsout.write( elem.name );
+        jsout.end_array();
+    }
+    jsout.end_array();
+
+    jsout.member( "vehicles" );
+    jsout.start_array();
+    for( auto &elem : sm.vehicles ) {
+        // json lib doesn't know how to turn a vehicle * into a vehicle,
+        // so we have to iterate manually.
+        jsout.write( *elem );
+    }
+    jsout.end_array();
+
+    // Output the computer
+    if (sm.comp.name != "") {
+        jsout.member( "computers", sm.comp.save_data() );
+    }
+
+    // Output base camp if any
+    if (sm.camp.is_valid()) {
+        jsout.member( "camp" );
+        jsout.write( sm.camp.save_data() );
+    }
+}
+
+/**
+ * Writes the members that are stored as fixed size arrays in the binary format.
+ */
+void save_submap_arrays( JsonOut &jsout, const submap &sm )
+{
+    jsout.member( "terrain" );
+    jsout.start_array();
+    for(int j = 0; j < SEEY; j++) {
+        for(int i = 0; i < SEEX; i++) {
+            // Save terrains
+            jsout.write( sm.ter[i][j].obj().id );
+        }
+    }
+    jsout.end_array();
+
+    // Write out the radiation array in a simple RLE scheme.
+    // written in intensity, count pairs
+    jsout.member( "radiation" );
+    jsout.start_array();
+    int lastrad = -1;
+    int count = 0;
+    for(int j = 0; j < SEEY; j++) {
+        for(int i = 0; i < SEEX; i++) {
+            // Save radiation, re-examine this because it doesn't look like it works right
+            int r = sm.get_radiation(i, j);
+            if (r == lastrad) {
+                count++;
+            } else {
+                if (count) {
+                    jsout.write( count );
+                }
+                jsout.write( r );
+                lastrad = r;
+                count = 1;
+            }
+        }
+    }
+    jsout.write( count );
+    jsout.end_array();
+
+    jsout.member("furniture");
+    jsout.start_array();
+    for(int j = 0; j < SEEY; j++) {
+        for(int i = 0; i < SEEX; i++) {
+            // Save furniture
+            if( sm.get_furn( i, j ) != f_null ) {
+                jsout.start_array();
+                jsout.write( i );
+                jsout.write( j );
+                jsout.write( sm.get_furn( i, j ).obj().id );
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+
+    jsout.member( "traps" );
+    jsout.start_array();
+    for(int j = 0; j < SEEY; j++) {
+        for(int i = 0; i < SEEX; i++) {
+            // Save traps
+            if (sm.get_trap( i, j ) != tr_null) {
+                jsout.start_array();
+                jsout.write( i );
+                jsout.write( j );
+                // TODO: jsout should support writting an id like jsout.write( trap_id )
+                jsout.write( sm.get_trap( i, j ).id().str() );
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+}
+
+/**
+ * Reads a single member of a submap object, except for "version" and "coordinates", which
+ * the caller has to handle.
+ */
+void unserialize_submap_member( JsonIn &jsin, submap &sm, const std::string &submap_member_name,
+                                const bool rubpow_update )
+{
+    if( submap_member_name == "turn_last_touched" ) {
+        sm.turn_last_touched = jsin.get_int();
+    } else if( submap_member_name == "temperature" ) {
+        sm.temperature = jsin.get_int();
+    } else if( submap_member_name == "terrain" ) {
+        // TODO: try block around this to error out if we come up short?
+        jsin.start_array();
+        // Small duplication here so that the update check is only performed once
+        if (rubpow_update) {
+            item rock = item("rock", 0);
+            item chunk = item("steel_chunk", 0);
+            for( int j = 0; j < SEEY; j++ ) {
+                for( int i = 0; i < SEEX; i++ ) {
+                    const ter_str_id tid( jsin.get_string() );
+
+                    if ( tid == "t_rubble" ) {
+                        sm.ter[i][j] = ter_id( "t_dirt" );
+                        sm.frn[i][j] = furnmap[ "f_rubble" ].loadid;
+                        sm.itm[i][j].push_back( rock );
+                        sm.itm[i][j].push_back( rock );
+                        sm.mark_item_tile( i, j );
+                    } else if ( tid == "t_wreckage" ){
+                        sm.ter[i][j] = ter_id( "t_dirt" );
+                        sm.frn[i][j] = furnmap[ "f_wreckage" ].loadid;
+                        sm.itm[i][j].push_back( chunk );
+                        sm.itm[i][j].push_back( chunk );
+                        sm.mark_item_tile( i, j );
+                    } else if ( tid == "t_ash" ){
+                        sm.ter[i][j] = ter_id(  "t_dirt" );
+                        sm.frn[i][j] = furnmap[ "f_ash" ].loadid;
+                    } else if ( tid == "t_pwr_sb_support_l" ){
+                        sm.ter[i][j] = ter_id(  "t_support_l" );
+                    } else if ( tid == "t_pwr_sb_switchgear_l" ){
+                        sm.ter[i][j] = ter_id(  "t_switchgear_l" );
+                    } else if ( tid == "t_pwr_sb_switchgear_s" ){
+                        sm.ter[i][j] = ter_id(  "t_switchgear_s" );
+                    } else {
+                        sm.ter[i][j] = tid.id();
+                    }
+                }
+            }
+        } else {
+            for( int j = 0; j < SEEY; j++ ) {
+                for( int i = 0; i < SEEX; i++ ) {
+                    const ter_str_id tid( jsin.get_string() );
+                    sm.ter[i][j] = tid.id();
+                }
+            }
+        }
+        jsin.end_array();
+    } else if( submap_member_name == "radiation" ) {
+        int rad_cell = 0;
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            int rad_strength = jsin.get_int();
+            int rad_num = jsin.get_int();
+            for( int i = 0; i < rad_num; ++i ) {
+                // A little array trick here, assign to it as a 1D array.
+                // If it's not in bounds we're kinda hosed anyway.
+                sm.set_radiation(0, rad_cell, rad_strength);
+                rad_cell++;
+            }
+        }
+    } else if( submap_member_name == "furniture" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            jsin.start_array();
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            sm.frn[i][j] = furnmap[ jsin.get_string() ].loadid;
+            jsin.end_array();
+        }
+    } else if( submap_member_name == "items" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            sm.mark_item_tile( i, j );
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                item tmp;
+                jsin.read( tmp );
+
+                if( tmp.is_emissive() ) {
+                    sm.update_lum_add(tmp, i, j);
+                }
+
+                tmp.visit_items( [ &sm, i, j ]( item *it ) {
+                    for( auto& e: it->magazine_convert() ) {
+                        sm.itm[i][j].push_back( e );
+                    }
+                    return VisitResponse::NEXT;
+                } );
+
+                sm.itm[i][j].push_back( tmp );
+                if( tmp.needs_processing() ) {
+                    sm.active_items.add( std::prev(sm.itm[i][j].end()), point( i, j ) );
+                }
+            }
+        }
+    } else if( submap_member_name == "traps" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            jsin.start_array();
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            // TODO: jsin should support returning an id like jsin.get_id<trap>()
+            sm.trp[i][j] = trap_str_id( jsin.get_string() );
+            jsin.end_array();
+        }
+    } else if( submap_member_name == "fields" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            // Coordinates loop
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                int type = jsin.get_int();
+                int density = jsin.get_int();
+                int age = jsin.get_int();
+                if (sm.fld[i][j].findField(field_id(type)) == NULL) {
+                    sm.field_count++;
+                    sm.mark_field_tile( i, j );
+                }
+                sm.fld[i][j].addField(field_id(type), density, age);
+            }
+        }
+    } else if( submap_member_name == "graffiti" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            jsin.start_array();
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            sm.set_graffiti( i, j, jsin.get_string() );
+            jsin.end_array();
+        }
+    } else if(submap_member_name == "cosmetics") {
+        jsin.start_array();
+        while (!jsin.end_array()) {
+            jsin.start_array();
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            jsin.read(sm.cosmetics[i][j]);
+            jsin.end_array();
+        }
+    } else if( submap_member_name == "spawns" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            jsin.start_array();
+            const mtype_id type = mtype_id( jsin.get_string() ); // TODO: json should know how to read an string_id
+            int count = jsin.get_int();
+            int i = jsin.get_int();
+            int j = jsin.get_int();
+            int faction_id = jsin.get_int();
+            int mission_id = jsin.get_int();
+            bool friendly = jsin.get_bool();
+            std::string name = jsin.get_string();
+            jsin.end_array();
+            spawn_point tmp( type, count, i, j, faction_id, mission_id, friendly, name );
+            sm.spawns.push_back( tmp );
+        }
+    } else if( submap_member_name == "vehicles" ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            vehicle *tmp = new vehicle();
+            jsin.read( *tmp );
+            sm.vehicles.push_back( tmp );
+        }
+    } else if( submap_member_name == "computers" ) {
+        std::string computer_data = jsin.get_string();
+        sm.comp.load_data( computer_data );
+    } else if( submap_member_name == "camp" ) {
+        std::string camp_data = jsin.get_string();
+        sm.camp.load_data( camp_data );
+    } else {
+        jsin.skip_value();
+    }
+}
+
+} // namespace
+
 void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
                            const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
                            bool delete_after_save )
@@ -194,16 +688,7 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         return;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname.c_str() );
-    std::ofstream fout;
-    fopen_exclusive( fout, filename.c_str() );
-    if( !fout.is_open() ) {
-        return;
-    }
-
-    JsonOut jsout( fout );
-    jsout.start_array();
+    std::vector<std::pair<tripoint, const submap *>> quad;
     for( auto &submap_addr : submap_addrs ) {
         if( submaps.count( submap_addr ) == 0 ) {
             continue;
@@ -213,6 +698,55 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         if( sm == nullptr ) {
             continue;
         }
+        quad.emplace_back( submap_addr, sm );
+    }
+
+    // Don't create the directory if it would be empty
+    assure_dir_exist( dirname.c_str() );
+    // Only one of the formats may exist, otherwise an outdated file could be loaded later.
+    // Saving in the other format also migrates the existing quads over time.
+    const bool binary = OPTIONS["BINARY_MAP_SAVES"];
+    const std::string path = filename + ( binary ? binary_map_extension : json_map_extension );
+    const std::string other_path = filename + ( binary ? json_map_extension : binary_map_extension );
+
+    std::ostringstream out;
+    if( binary ) {
+        save_binary_quad( out, quad );
+    } else {
+        save_json_quad( out, quad );
+    }
+
+    if( MAP_SHARING::isSharing() ) {
+        // The lock files of map sharing can only be handled here on the main thread.
+        std::ofstream fout;
+        fopen_exclusive( fout, path.c_str(), std::ios::out | std::ios::binary );
+        if( !fout.is_open() ) {
+            return;
+        }
+        const std::string data = out.str();
+        fout.write( data.data(), data.size() );
+        fclose_exclusive( fout, path.c_str() );
+        if( file_exist( other_path ) ) {
+            remove_file( other_path );
+        }
+    } else {
+        io.write( om_addr, path, other_path, out.str() );
+    }
+    if( delete_after_save ) {
+        for( auto &elem : quad ) {
+            submaps_to_delete.push_back( elem.first );
+        }
+    }
+}
+
+void mapbuffer::save_json_quad( std::ostream &fout,
+                                const std::vector<std::pair<tripoint, const submap *>> &quad )
+{
+    JsonOut jsout( fout );
+    jsout.start_array();
+    for( auto &elem : quad ) {
+        const tripoint &submap_addr = elem.first;
+        const submap &sm = *elem.second;
 
         jsout.start_object();
 
@@ -225,192 +759,187 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         jsout.write( submap_addr.z );
         jsout.end_array();
 
-        jsout.member( "turn_last_touched", sm->turn_last_touched );
-        jsout.member( "temperature", sm->temperature );
+        jsout.member( "turn_last_touched", sm.turn_last_touched );
+        jsout.member( "temperature", sm.temperature );
 
-        jsout.member( "terrain" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save terrains
-                jsout.write( sm->ter[i][j].obj().id );
-            }
-        }
-        jsout.end_array();
+        save_submap_arrays( jsout, sm );
+        save_submap_contents( jsout, sm );
 
-        // Write out the radiation array in a simple RLE scheme.
-        // written in intensity, count pairs
-        jsout.member( "radiation" );
-        jsout.start_array();
-        int lastrad = -1;
-        int count = 0;
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save radiation, re-examine this because it doesn't look like it works right
-                int r = sm->get_radiation(i, j);
-                if (r == lastrad) {
-                    count++;
-                } else {
-                    if (count) {
-                        jsout.write( count );
-                    }
-                    jsout.write( r );
-                    lastrad = r;
-                    count = 1;
-                }
-            }
-        }
-        jsout.write( count );
-        jsout.end_array();
+        jsout.end_object();
+    }
 
-        jsout.member("furniture");
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save furniture
-                if( sm->get_furn( i, j ) != f_null ) {
-                    jsout.start_array();
-                    jsout.write( i );
-                    jsout.write( j );
-                    jsout.write( sm->get_furn( i, j ).obj().id );
-                    jsout.end_array();
-                }
+    jsout.end_array();
+}
+
+void mapbuffer::save_binary_quad( std::ostream &fout,
+                                  const std::vector<std::pair<tripoint, const submap *>> &quad )
+{
+    // The palettes precede the arrays, so those are written into a buffer first.
+    std::ostringstream body;
+    binary_writer body_out( body );
+    binary_palette ter_palette;
+    binary_palette furn_palette;
+    binary_palette trap_palette;
+
+    body_out.write<uint32_t>( quad.size() );
+    for( auto &elem : quad ) {
+        const tripoint &submap_addr = elem.first;
+        const submap &sm = *elem.second;
+
+        body_out.write<int32_t>( submap_addr.x );
+        body_out.write<int32_t>( submap_addr.y );
+        body_out.write<int32_t>( submap_addr.z );
+        body_out.write<int32_t>( sm.turn_last_touched );
+        body_out.write<int32_t>( sm.temperature );
+
+        for( int i = 0; i < SEEX; i++ ) {
+            for( int j = 0; j < SEEY; j++ ) {
+                const ter_id ter = sm.get_ter( i, j );
+                body_out.write( ter_palette.index_of( ter.to_i(), ter.obj().id.str() ) );
             }
         }
-        jsout.end_array();
-
-        jsout.member( "items" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                if( sm->itm[i][j].empty() ) {
-                    continue;
-                }
-                jsout.write( i );
-                jsout.write( j );
-                jsout.write( sm->itm[i][j] );
+        for( int i = 0; i < SEEX; i++ ) {
+            for( int j = 0; j < SEEY; j++ ) {
+                const furn_id furn = sm.get_furn( i, j );
+                body_out.write( furn_palette.index_of( furn.to_i(), furn.obj().id ) );
             }
         }
-        jsout.end_array();
-
-        jsout.member( "traps" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save traps
-                if (sm->get_trap( i, j ) != tr_null) {
-                    jsout.start_array();
-                    jsout.write( i );
-                    jsout.write( j );
-                    // TODO: jsout should support writting an id like jsout.write( trap_id )
-                    jsout.write( sm->get_trap( i, j ).id().str() );
-                    jsout.end_array();
-                }
+        for( int i = 0; i < SEEX; i++ ) {
+            for( int j = 0; j < SEEY; j++ ) {
+                const trap_id trap = sm.get_trap( i, j );
+                body_out.write( trap_palette.index_of( trap.to_i(), trap.id().str() ) );
             }
         }
-        jsout.end_array();
-
-        jsout.member( "fields" );
-        jsout.start_array();
-        for(int j = 0; j < SEEY; j++) {
-            for(int i = 0; i < SEEX; i++) {
-                // Save fields
-                if (sm->fld[i][j].fieldCount() > 0) {
-                    jsout.write( i );
-                    jsout.write( j );
-                    jsout.start_array();
-                    for( auto &fld : sm->fld[i][j] ) {
-                        const field_entry &cur = fld.second;
-                            // We don't seem to have a string identifier for fields anywhere.
-                            jsout.write( cur.getFieldType() );
-                            jsout.write( cur.getFieldDensity() );
-                            jsout.write( cur.getFieldAge() );
-                    }
-                    jsout.end_array();
-                }
+        for( int i = 0; i < SEEX; i++ ) {
+            for( int j = 0; j < SEEY; j++ ) {
+                body_out.write<int32_t>( sm.get_radiation( i, j ) );
             }
         }
-        jsout.end_array();
-
-        jsout.member("cosmetics");
-        jsout.start_array();
-        for (int j = 0; j < SEEY; j++) {
-            for (int i = 0; i < SEEX; i++) {
-                if (sm->cosmetics[i][j].size() > 0) {
-                    jsout.start_array();
-                    jsout.write(i);
-                    jsout.write(j);
-                    jsout.write(sm->cosmetics[i][j]);
-                    jsout.end_array();
-                }
+        for( int i = 0; i < SEEX; i++ ) {
+            for( int j = 0; j < SEEY; j++ ) {
+                body_out.write<uint8_t>( sm.lum[i][j] );
             }
         }
-        jsout.end_array();
 
-        // Output the spawn points
-        jsout.member( "spawns" );
-        jsout.start_array();
-        for( auto &elem : sm->spawns ) {
-            jsout.start_array();
-            jsout.write( elem.type.str() ); // TODO: json should know how to write string_ids
-            jsout.write( elem.count );
-            jsout.write( elem.posx );
-            jsout.write( elem.posy );
-            jsout.write( elem.faction_id );
-            jsout.write( elem.mission_id );
-            jsout.write( elem.friendly );
-            jsout.write( elem.name );
-            jsout.end_array();
-        }
-        jsout.end_array();
+        std::ostringstream json;
+        JsonOut jsout( json );
+        jsout.start_object();
+        save_submap_contents( jsout, sm );
+        jsout.end_object();
 
-        jsout.member( "vehicles" );
-        jsout.start_array();
-        for( auto &elem : sm->vehicles ) {
-            // json lib doesn't know how to turn a vehicle * into a vehicle,
-            // so we have to iterate manually.
-            jsout.write( *elem );
+        body_out.write<uint32_t>( 1 );
+        body_out.write( json_section );
+        body_out.write( json.str() );
+    }
+
+    binary_writer out( fout );
+    fout.write( binary_map_magic, sizeof( binary_map_magic ) );
+    out.write( binary_map_version );
+    out.write( binary_map_byte_order );
+    out.write<int32_t>( savegame_version );
+    ter_palette.write( out );
+    furn_palette.write( out );
+    trap_palette.write( out );
+    const std::string body_data = body.str();
+    fout.write( body_data.data(), body_data.size() );
+}
+
+std::vector<std::pair<tripoint, std::unique_ptr<submap>>> mapbuffer::unserialize_binary_quad(
+            const char *const data, const size_t size )
+{
+    binary_reader in( data, size );
+    if( std::memcmp( in.get( sizeof( binary_map_magic ) ), binary_map_magic,
+                     sizeof( binary_map_magic ) ) != 0 ) {
+        throw std::runtime_error( "not a binary map file" );
+    }
+    const uint32_t version = in.read<uint32_t>();
+    if( version != binary_map_version ) {
+        throw std::runtime_error( string_format( "unsupported binary map version %d", version ) );
+    }
+    if( in.read<uint32_t>() != binary_map_byte_order ) {
+        throw std::runtime_error( "binary map file has been written with a different byte order" );
+    }
+    const bool rubpow_update = in.read<int32_t>() < 22;
+
+    const auto ter_palette = read_palette<ter_id>( in, []( const std::string & id ) {
+        return ter_str_id( id ).id();
+    } );
+    const auto furn_palette = read_palette<furn_id>( in, []( const std::string & id ) {
+        return furnmap[ id ].loadid;
+    } );
+    const auto trap_palette = read_palette<trap_id>( in, []( const std::string & id ) {
+        return trap_str_id( id ).id();
+    } );
+
+    std::vector<std::pair<tripoint, std::unique_ptr<submap>>> result;
+    const uint32_t count = in.read<uint32_t>();
+    for( uint32_t n = 0; n < count; n++ ) {
+        std::unique_ptr<submap> sm( new submap() );
+        const int x = in.read<int32_t>();
+        const int y = in.read<int32_t>();
+        const int z = in.read<int32_t>();
+        sm->turn_last_touched = in.read<int32_t>();
+        sm->temperature = in.read<int32_t>();
+
+        read_palette_array( in, ter_palette, sm->ter );
+        read_palette_array( in, furn_palette, sm->frn );
+        read_palette_array( in, trap_palette, sm->trp );
+        for( int i = 0; i < SEEX; i++ ) {
+            for( int j = 0; j < SEEY; j++ ) {
+                sm->rad[i][j] = in.read<int32_t>();
+            }
         }
-        jsout.end_array();
+        // Loading the items adds their light, so the stored values are applied afterwards.
+        std::uint8_t lum[SEEX][SEEY];
+        std::memcpy( lum, in.get( sizeof( lum ) ), sizeof( lum ) );
 
-        // Output the computer
-        if (sm->comp.name != "") {
-            jsout.member( "computers", sm->comp.save_data() );
+        const uint32_t sections = in.read<uint32_t>();
+        for( uint32_t s = 0; s < sections; s++ ) {
+            const uint32_t tag = in.read<uint32_t>();
+            const uint32_t length = in.read<uint32_t>();
+            const char *const section = in.get( length );
+            if( tag != json_section ) {
+                continue;
+            }
+            std::istringstream json( std::string( section, length ) );
+            JsonIn jsin( json );
+            jsin.start_object();
+            while( !jsin.end_object() ) {
+                const std::string member_name = jsin.get_member_name();
+                unserialize_submap_member( jsin, *sm, member_name, rubpow_update );
+            }
         }
+        std::memcpy( sm->lum, lum, sizeof( lum ) );
+        result.emplace_back( tripoint( x, y, z ), std::move( sm ) );
+    }
+    return result;
+}
 
-        // Output base camp if any
-        if (sm->camp.is_valid()) {
-            jsout.member( "camp" );
-            jsout.write( sm->camp.save_data() );
+bool mapbuffer::add_binary_quad( const char *const data, const size_t size,
+                                 const std::string &path, const std::string &json_path )
+{
+    std::vector<std::pair<tripoint, std::unique_ptr<submap>>> quad;
+    try {
+        quad = unserialize_binary_quad( data, size );
+    } catch( const std::exception &err ) {
+        if( !file_exist( json_path ) ) {
+            throw;
         }
-        if( delete_after_save ) {
-            submaps_to_delete.push_back( submap_addr );
+        dbg( D_ERROR ) << "failed to load " << path << ", using the JSON file: " << err.what();
+        return false;
+    }
+    for( auto &elem : quad ) {
+        if( !add_submap( elem.first, elem.second ) ) {
+            debugmsg( "submap %d,%d,%d was already loaded", elem.first.x, elem.first.y, elem.first.z );
         }
-        jsout.end_object();
     }
-
-    jsout.end_array();
-    fclose_exclusive( fout, filename.c_str() );
+    return true;
 }
 
 // We're reading in way too many entities here to mess around with creating sub-objects and
 // seeking around in them, so we're using the json streaming API.
-submap *mapbuffer::unserialize_submaps( const tripoint &p )
+void mapbuffer::add_json_quad( std::istream &fin )
 {
-    // Map the tripoint to the submap quad that stores it.
-    const tripoint om_addr = sm_to_omt_copy( p );
-    const tripoint segment_addr = omt_to_seg_copy( om_addr );
-    std::stringstream quad_path;
-    quad_path << world_generator->active_world->world_path << "/maps/" <<
-              segment_addr.x << "." << segment_addr.y << "." << segment_addr.z << "/" <<
-              om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
-
-    std::ifstream fin( quad_path.str().c_str() );
-    if( !fin.is_open() ) {
-        // If it doesn't exist, trigger generating it.
-        return NULL;
-    }
-
     JsonIn jsin( fin );
     jsin.start_array();
     while( !jsin.end_array() ) {
@@ -431,179 +960,8 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
                 int locz = jsin.get_int();
                 jsin.end_array();
                 submap_coordinates = tripoint( locx, locy, locz );
-            } else if( submap_member_name == "turn_last_touched" ) {
-                sm->turn_last_touched = jsin.get_int();
-            } else if( submap_member_name == "temperature" ) {
-                sm->temperature = jsin.get_int();
-            } else if( submap_member_name == "terrain" ) {
-                // TODO: try block around this to error out if we come up short?
-                jsin.start_array();
-                // Small duplication here so that the update check is only performed once
-                if (rubpow_update) {
-                    item rock = item("rock", 0);
-                    item chunk = item("steel_chunk", 0);
-                    for( int j = 0; j < SEEY; j++ ) {
-                        for( int i = 0; i < SEEX; i++ ) {
-                            const ter_str_id tid( jsin.get_string() );
-
-                            if ( tid == "t_rubble" ) {
-                                sm->ter[i][j] = ter_id( "t_dirt" );
-                                sm->frn[i][j] = furnmap[ "f_rubble" ].loadid;
-                                sm->itm[i][j].push_back( rock );
-                                sm->itm[i][j].push_back( rock );
-                            } else if ( tid == "t_wreckage" ){
-                                sm->ter[i][j] = ter_id( "t_dirt" );
-                                sm->frn[i][j] = furnmap[ "f_wreckage" ].loadid;
-                                sm->itm[i][j].push_back( chunk );
-                                sm->itm[i][j].push_back( chunk );
-                            } else if ( tid == "t_ash" ){
-                                sm->ter[i][j] = ter_id(  "t_dirt" );
-                                sm->frn[i][j] = furnmap[ "f_ash" ].loadid;
-                            } else if ( tid == "t_pwr_sb_support_l" ){
-                                sm->ter[i][j] = ter_id(  "t_support_l" );
-                            } else if ( tid == "t_pwr_sb_switchgear_l" ){
-                                sm->ter[i][j] = ter_id(  "t_switchgear_l" );
-                            } else if ( tid == "t_pwr_sb_switchgear_s" ){
-                                sm->ter[i][j] = ter_id(  "t_switchgear_s" );
-                            } else {
-                                sm->ter[i][j] = tid.id();
-                            }
-                        }
-                    }
-                } else {
-                    for( int j = 0; j < SEEY; j++ ) {
-                        for( int i = 0; i < SEEX; i++ ) {
-                            const ter_str_id tid( jsin.get_string() );
-                            sm->ter[i][j] = tid.id();
-                        }
-                    }
-                }
-                jsin.end_array();
-            } else if( submap_member_name == "radiation" ) {
-                int rad_cell = 0;
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    int rad_strength = jsin.get_int();
-                    int rad_num = jsin.get_int();
-                    for( int i = 0; i < rad_num; ++i ) {
-                        // A little array trick here, assign to it as a 1D array.
-                        // If it's not in bounds we're kinda hosed anyway.
-                        sm->set_radiation(0, rad_cell, rad_strength);
-                        rad_cell++;
-                    }
-                }
-            } else if( submap_member_name == "furniture" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    sm->frn[i][j] = furnmap[ jsin.get_string() ].loadid;
-                    jsin.end_array();
-                }
-            } else if( submap_member_name == "items" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    jsin.start_array();
-                    while( !jsin.end_array() ) {
-                        item tmp;
-                        jsin.read( tmp );
-
-                        if( tmp.is_emissive() ) {
-                            sm->update_lum_add(tmp, i, j);
-                        }
-
-                        tmp.visit_items( [ &sm, i, j ]( item *it ) {
-                            for( auto& e: it->magazine_convert() ) {
-                                sm->itm[i][j].push_back( e );
-                            }
-                            return VisitResponse::NEXT;
-                        } );
-
-                        sm->itm[i][j].push_back( tmp );
-                        if( tmp.needs_processing() ) {
-                            sm->active_items.add( std::prev(sm->itm[i][j].end()), point( i, j ) );
-                        }
-                    }
-                }
-            } else if( submap_member_name == "traps" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    // TODO: jsin should support returning an id like jsin.get_id<trap>()
-                    sm->trp[i][j] = trap_str_id( jsin.get_string() );
-                    jsin.end_array();
-                }
-            } else if( submap_member_name == "fields" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    // Coordinates loop
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    jsin.start_array();
-                    while( !jsin.end_array() ) {
-                        int type = jsin.get_int();
-                        int density = jsin.get_int();
-                        int age = jsin.get_int();
-                        if (sm->fld[i][j].findField(field_id(type)) == NULL) {
-                            sm->field_count++;
-                        }
-                        sm->fld[i][j].addField(field_id(type), density, age);
-                    }
-                }
-            } else if( submap_member_name == "graffiti" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    sm->set_graffiti( i, j, jsin.get_string() );
-                    jsin.end_array();
-                }
-            } else if(submap_member_name == "cosmetics") {
-                jsin.start_array();
-                while (!jsin.end_array()) {
-                    jsin.start_array();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    jsin.read(sm->cosmetics[i][j]);
-                    jsin.end_array();
-                }
-            } else if( submap_member_name == "spawns" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    jsin.start_array();
-                    const mtype_id type = mtype_id( jsin.get_string() ); // TODO: json should know how to read an string_id
-                    int count = jsin.get_int();
-                    int i = jsin.get_int();
-                    int j = jsin.get_int();
-                    int faction_id = jsin.get_int();
-                    int mission_id = jsin.get_int();
-                    bool friendly = jsin.get_bool();
-                    std::string name = jsin.get_string();
-                    jsin.end_array();
-                    spawn_point tmp( type, count, i, j, faction_id, mission_id, friendly, name );
-                    sm->spawns.push_back( tmp );
-                }
-            } else if( submap_member_name == "vehicles" ) {
-                jsin.start_array();
-                while( !jsin.end_array() ) {
-                    vehicle *tmp = new vehicle();
-                    jsin.read( *tmp );
-                    sm->vehicles.push_back( tmp );
-                }
-            } else if( submap_member_name == "computers" ) {
-                std::string computer_data = jsin.get_string();
-                sm->comp.load_data( computer_data );
-            } else if( submap_member_name == "camp" ) {
-                std::string camp_data = jsin.get_string();
-                sm->camp.load_data( camp_data );
             } else {
-                jsin.skip_value();
+                unserialize_submap_member( jsin, *sm, submap_member_name, rubpow_update );
             }
         }
         if( !add_submap( submap_coordinates, sm ) ) {
@@ -611,8 +969,74 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
                       submap_coordinates.z );
         }
     }
+}
+
+submap *mapbuffer::unserialize_submaps( const tripoint &p )
+{
+    // Map the tripoint to the submap quad that stores it.
+    const tripoint om_addr = sm_to_omt_copy( p );
+    const std::string path = quad_file_path( om_addr );
+    const std::string binary_path = path + binary_map_extension;
+    const std::string json_path = path + json_map_extension;
+
+    // Prefer the binary file, fall back to the JSON file if it's missing or can't be used.
+    quad_file staged;
+    if( io.take( om_addr, staged ) ) {
+        if( staged.path.empty() ) {
+            // The prefetch found no file, trigger generating it.
+            return NULL;
+        } else if( staged.path == json_path ) {
+            std::istringstream fin( staged.data );
+            add_json_quad( fin );
+            return find_loaded_submap( p, json_path );
+        } else if( add_binary_quad( staged.data.data(), staged.data.size(), binary_path, json_path ) ) {
+            return find_loaded_submap( p, binary_path );
+        }
+    } else {
+        const mapped_file binary_file( binary_path );
+        if( binary_file.is_open() &&
+            add_binary_quad( binary_file.data(), binary_file.size(), binary_path, json_path ) ) {
+            return find_loaded_submap( p, binary_path );
+        }
+    }
+
+    std::ifstream fin( json_path.c_str() );
+    if( !fin.is_open() ) {
+        // If it doesn't exist, trigger generating it.
+        return NULL;
+    }
+    add_json_quad( fin );
+    return find_loaded_submap( p, json_path );
+}
+
+void mapbuffer::prefetch( const tripoint &p )
+{
+    // Other processes may change the files when the map is shared.
+    if( submaps.count( p ) > 0 || MAP_SHARING::isSharing() ) {
+        return;
+    }
+    const tripoint om_addr = sm_to_omt_copy( p );
+    const std::string path = quad_file_path( om_addr );
+    io.prefetch( om_addr, { path + binary_map_extension, path + json_map_extension } );
+}
+
+void mapbuffer::flush()
+{
+    io.flush();
+    report_failed_writes();
+}
+
+void mapbuffer::report_failed_writes()
+{
+    for( auto &path : io.take_failed_writes() ) {
+        dbg( D_ERROR ) << "failed to save " << path;
+    }
+}
+
+submap *mapbuffer::find_loaded_submap( const tripoint &p, const std::string &path )
+{
     if( submaps.count( p ) == 0 ) {
-        debugmsg("file %s did not contain the expected submap %d,%d,%d", quad_path.str().c_str(), p.x, p.y,
+        debugmsg("file %s did not contain the expected submap %d,%d,%d", path.c_str(), p.x, p.y,
                  p.z);
         return NULL;
     }
@@ -5,7 +5,11 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
+#include <utility>
+#include <iosfwd>
 #include "enums.h"
+#include "mapbuffer_io.h"
 struct point;
 struct tripoint;
 struct submap;
@@ -24,12 +28,22 @@ class mapbuffer
         /** Store all submaps in this instance into savefiles.
          * @ref delete_after_save If true, the saved submaps are removed
          * from the mapbuffer (and deleted).
+         * The files are written in the background, see @ref flush.
          **/
         void save( bool delete_after_save = false );
+        /** Blocks until everything saved by @ref save is on disk. **/
+        void flush();
 
-        /** Delete all buffered submaps. **/
+        /** Delete all buffered submaps. Waits for pending saves. **/
         void reset();
 
+        /**
+         * Starts reading the file of the submap at p in the background, so that
+         * @ref lookup_submap does not have to wait for the disk when it is needed.
+         * Does nothing if the submap is already loaded.
+         */
+        void prefetch( const tripoint &p );
+
         /** Add a new submap to the buffer.
          *
          * @param x, y, z The absolute world position in submap coordinates.
@@ -73,10 +87,39 @@ class mapbuffer
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
         submap *unserialize_submaps( const tripoint &p );
+        /**
+         * Adds the submaps from the binary quad file content.
+         * @return false if the content is broken but there is a JSON file at json_path
+         * that can be used instead. Throws if there is no such file.
+         */
+        bool add_binary_quad( const char *data, size_t size, const std::string &path,
+                              const std::string &json_path );
+        /** Adds the submaps from the JSON quad file content. */
+        void add_json_quad( std::istream &fin );
+        void report_failed_writes();
+        /**
+         * Reads the binary format of a quad file (see mapbuffer.cpp for the layout).
+         * Throws if the data is not usable.
+         * @return The submaps of the quad with their absolute coordinates.
+         */
+        static std::vector<std::pair<tripoint, std::unique_ptr<submap>>> unserialize_binary_quad(
+                    const char *data, size_t size );
+        /** Returns the submap at p, which should just have been loaded from the file at path. */
+        submap *find_loaded_submap( const tripoint &p, const std::string &path );
+        /**
+         * Saves the (up to four) submaps of the overmap terrain at om_addr.
+         * @param filename Path of the quad file without the extension, which depends
+         * on the save format.
+         */
         void save_quad( const std::string &dirname, const std::string &filename,
                         const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
                         bool delete_after_save );
+        static void save_json_quad( std::ostream &fout,
+                                    const std::vector<std::pair<tripoint, const submap *>> &quad );
+        static void save_binary_quad( std::ostream &fout,
+                                      const std::vector<std::pair<tripoint, const submap *>> &quad );
         submap_map_t submaps;
+        quad_io_worker io;
 };
 
 extern mapbuffer MAPBUFFER;
@@ -0,0 +1,346 @@
+#include "mapbuffer_io.h"
+
+#include "filesystem.h"
+
+#include <fstream>
+#include <iterator>
+
+#if !(defined __MINGW32__ && !defined _GLIBCXX_HAS_GTHREADS)
+#   define CATA_QUAD_IO_THREADS
+#   include <condition_variable>
+#   include <mutex>
+#   include <thread>
+#endif
+
+namespace {
+
+/** Staged quads that haven't been taken yet are dropped (oldest first) beyond this. */
+const size_t max_staged_quads = 64;
+
+bool read_file( const std::vector<std::string> &paths, quad_file &result )
+{
+    for( auto &path : paths ) {
+        std::ifstream fin( path.c_str(), std::ios::binary );
+        if( !fin.is_open() ) {
+            continue;
+        }
+        result.path = path;
+        result.data.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+        return !fin.bad();
+    }
+    // No file is fine as well, the quad has to be generated.
+    result.path.clear();
+    result.data.clear();
+    return true;
+}
+
+bool write_file( const std::string &path, const std::string &obsolete_path,
+                 const std::string &data )
+{
+    std::ofstream fout( path.c_str(), std::ios::binary | std::ios::trunc );
+    if( !fout.is_open() ) {
+        return false;
+    }
+    fout.write( data.data(), data.size() );
+    fout.close();
+    if( fout.fail() ) {
+        return false;
+    }
+    if( file_exist( obsolete_path ) ) {
+        remove_file( obsolete_path );
+    }
+    return true;
+}
+
+} // namespace
+
+#ifdef CATA_QUAD_IO_THREADS
+
+struct quad_io_worker::impl {
+    enum read_state {
+        queued,
+        reading,
+        done,
+    };
+    struct read_job {
+        std::vector<std::string> paths;
+        read_state state = queued;
+        /** Order of the requests, older jobs are handled first and evicted first. */
+        unsigned long sequence = 0;
+        quad_file file;
+    };
+    struct write_job {
+        std::string path;
+        std::string obsolete_path;
+        std::string data;
+        /** Changes whenever the job is replaced by a newer write of the same quad. */
+        unsigned long sequence = 0;
+        bool in_progress = false;
+    };
+
+    std::mutex mutex;
+    /** Wakes up the worker thread. */
+    std::condition_variable work_available;
+    /** Signaled by the worker thread whenever a job has been finished. */
+    std::condition_variable job_done;
+    std::thread thread;
+    bool stopping = false;
+    unsigned long next_sequence = 0;
+    std::map<tripoint, read_job> reads;
+    std::map<tripoint, write_job> writes;
+    std::vector<std::string> failed_writes;
+
+    ~impl() {
+        if( !thread.joinable() ) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopping = true;
+        }
+        work_available.notify_one();
+        thread.join();
+    }
+
+    /** Must be called with the mutex locked. */
+    void start_thread() {
+        if( !thread.joinable() ) {
+            thread = std::thread( [this]() {
+                run();
+            } );
+        }
+    }
+
+    std::map<tripoint, write_job>::iterator next_write() {
+        for( auto iter = writes.begin(); iter != writes.end(); ++iter ) {
+            if( !iter->second.in_progress ) {
+                return iter;
+            }
+        }
+        return writes.end();
+    }
+
+    std::map<tripoint, read_job>::iterator next_read() {
+        auto result = reads.end();
+        for( auto iter = reads.begin(); iter != reads.end(); ++iter ) {
+            if( iter->second.state == queued &&
+                ( result == reads.end() || iter->second.sequence < result->second.sequence ) ) {
+                result = iter;
+            }
+        }
+        return result;
+    }
+
+    void evict_staged() {
+        size_t staged = 0;
+        auto oldest = reads.end();
+        for( auto iter = reads.begin(); iter != reads.end(); ++iter ) {
+            if( iter->second.state != done ) {
+                continue;
+            }
+            staged++;
+            if( oldest == reads.end() || iter->second.sequence < oldest->second.sequence ) {
+                oldest = iter;
+            }
+        }
+        if( staged > max_staged_quads ) {
+            reads.erase( oldest );
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ) {
+            // Writes go first, they are needed for a consistent save.
+            const auto write = next_write();
+            if( write != writes.end() ) {
+                const tripoint om_addr = write->first;
+                write_job &job = write->second;
+                job.in_progress = true;
+                const unsigned long sequence = job.sequence;
+                const std::string path = job.path;
+                const std::string obsolete_path = job.obsolete_path;
+                // Copied because take may hand it out while the file is being written.
+                const std::string data = job.data;
+                lock.unlock();
+                const bool success = write_file( path, obsolete_path, data );
+                lock.lock();
+                if( !success ) {
+                    failed_writes.push_back( path );
+                }
+                const auto iter = writes.find( om_addr );
+                if( iter != writes.end() && iter->second.sequence == sequence ) {
+                    writes.erase( iter );
+                } else if( iter != writes.end() ) {
+                    // Replaced while being written, the newer data still needs to be written.
+                    iter->second.in_progress = false;
+                }
+                job_done.notify_all();
+                continue;
+            }
+            if( stopping ) {
+                return;
+            }
+            const auto read = next_read();
+            if( read != reads.end() ) {
+                const tripoint om_addr = read->first;
+                read->second.state = reading;
+                const unsigned long sequence = read->second.sequence;
+                const std::vector<std::string> paths = read->second.paths;
+                quad_file file;
+                lock.unlock();
+                const bool success = read_file( paths, file );
+                lock.lock();
+                const auto iter = reads.find( om_addr );
+                // The job is gone if it has been dropped or superseded by a write meanwhile.
+                if( iter != reads.end() && iter->second.sequence == sequence ) {
+                    if( success ) {
+                        iter->second.state = done;
+                        iter->second.file = std::move( file );
+                        evict_staged();
+                    } else {
+                        // Let the main thread read it again and report the error.
+                        reads.erase( iter );
+                    }
+                }
+                job_done.notify_all();
+                continue;
+            }
+            work_available.wait( lock );
+        }
+    }
+};
+
+quad_io_worker::quad_io_worker() : pimpl( new impl() )
+{
+}
+
+quad_io_worker::~quad_io_worker() = default;
+
+void quad_io_worker::prefetch( const tripoint &om_addr, const std::vector<std::string> &paths )
+{
+    {
+        std::lock_guard<std::mutex> lock( pimpl->mutex );
+        if( pimpl->reads.count( om_addr ) > 0 || pimpl->writes.count( om_addr ) > 0 ) {
+            return;
+        }
+        impl::read_job &job = pimpl->reads[om_addr];
+        job.paths = paths;
+        job.sequence = pimpl->next_sequence++;
+        pimpl->start_thread();
+    }
+    pimpl->work_available.notify_one();
+}
+
+bool quad_io_worker::take( const tripoint &om_addr, quad_file &result )
+{
+    std::unique_lock<std::mutex> lock( pimpl->mutex );
+    const auto write = pimpl->writes.find( om_addr );
+    if( write != pimpl->writes.end() ) {
+        result.path = write->second.path;
+        result.data = write->second.data;
+        return true;
+    }
+    auto read = pimpl->reads.find( om_addr );
+    while( read != pimpl->reads.end() && read->second.state == impl::reading ) {
+        pimpl->job_done.wait( lock );
+        read = pimpl->reads.find( om_addr );
+    }
+    if( read == pimpl->reads.end() ) {
+        return false;
+    }
+    if( read->second.state == impl::done ) {
+        result = std::move( read->second.file );
+        pimpl->reads.erase( read );
+        return true;
+    }
+    // Not started yet, reading it right here is faster than waiting for the queue.
+    const std::vector<std::string> paths = read->second.paths;
+    pimpl->reads.erase( read );
+    lock.unlock();
+    return read_file( paths, result );
+}
+
+void quad_io_worker::write( const tripoint &om_addr, const std::string &path,
+                            const std::string &obsolete_path, std::string data )
+{
+    {
+        std::lock_guard<std::mutex> lock( pimpl->mutex );
+        pimpl->reads.erase( om_addr );
+        impl::write_job &job = pimpl->writes[om_addr];
+        job.path = path;
+        job.obsolete_path = obsolete_path;
+        job.data = std::move( data );
+        job.sequence = pimpl->next_sequence++;
+        pimpl->start_thread();
+    }
+    pimpl->work_available.notify_one();
+}
+
+void quad_io_worker::flush()
+{
+    std::unique_lock<std::mutex> lock( pimpl->mutex );
+    while( !pimpl->writes.empty() ) {
+        pimpl->job_done.wait( lock );
+    }
+}
+
+void quad_io_worker::clear_staged()
+{
+    std::lock_guard<std::mutex> lock( pimpl->mutex );
+    pimpl->reads.clear();
+}
+
+std::vector<std::string> quad_io_worker::take_failed_writes()
+{
+    std::lock_guard<std::mutex> lock( pimpl->mutex );
+    std::vector<std::string> result;
+    result.swap( pimpl->failed_writes );
+    return result;
+}
+
+#else // CATA_QUAD_IO_THREADS
+
+struct quad_io_worker::impl {
+    std::vector<std::string> failed_writes;
+};
+
+quad_io_worker::quad_io_worker() : pimpl( new impl() )
+{
+}
+
+quad_io_worker::~quad_io_worker() = default;
+
+void quad_io_worker::prefetch( const tripoint &, const std::vector<std::string> & )
+{
+}
+
+bool quad_io_worker::take( const tripoint &, quad_file & )
+{
+    return false;
+}
+
+void quad_io_worker::write( const tripoint &, const std::string &path,
+                            const std::string &obsolete_path, std::string data )
+{
+    if( !write_file( path, obsolete_path, data ) ) {
+        pimpl->failed_writes.push_back( path );
+    }
+}
+
+void quad_io_worker::flush()
+{
+}
+
+void quad_io_worker::clear_staged()
+{
+}
+
+std::vector<std::string> quad_io_worker::take_failed_writes()
+{
+    std::vector<std::string> result;
+    result.swap( pimpl->failed_writes );
+    return result;
+}
+
+#endif // CATA_QUAD_IO_THREADS
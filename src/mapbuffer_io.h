@@ -0,0 +1,71 @@
+#ifndef MAPBUFFER_IO_H
+#define MAPBUFFER_IO_H
+
+#include "enums.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Content of a quad file (see @ref mapbuffer), read into memory.
+ */
+struct quad_file {
+    /** Path of the file, its extension tells the format. Empty if no file exists. */
+    std::string path;
+    std::string data;
+};
+
+/**
+ * Moves the disk access of the @ref mapbuffer off the main thread.
+ *
+ * Quads that are likely to be needed soon can be prefetched: their file is read into a
+ * staging area in the background and @ref take hands it over without touching the disk.
+ * Saved quads are serialized by the caller and written in the background (write-behind).
+ * Until a write has finished, @ref take returns the queued content, so the main thread
+ * never reads a file that is about to be replaced.
+ *
+ * Only raw file content is handled here. Parsing creates items, vehicles and so on,
+ * which is not thread safe, so it stays on the main thread.
+ *
+ * Without thread support everything happens synchronously.
+ */
+class quad_io_worker
+{
+    public:
+        quad_io_worker();
+        ~quad_io_worker();
+
+        /**
+         * Queues reading the file of the quad at om_addr, unless it is staged or queued already.
+         * @param paths Candidate files, the first one that exists is read.
+         */
+        void prefetch( const tripoint &om_addr, const std::vector<std::string> &paths );
+        /**
+         * Hands over the staged or queued-for-writing content of the quad at om_addr.
+         * Waits if the quad is being read right now, reads it directly if its read is
+         * still queued.
+         * @return false if the quad has not been prefetched (or reading it failed),
+         * the caller has to read it.
+         */
+        bool take( const tripoint &om_addr, quad_file &result );
+        /**
+         * Queues writing data to the file at path, replacing an earlier queued write of the
+         * quad. The file at obsolete_path is removed afterwards.
+         */
+        void write( const tripoint &om_addr, const std::string &path,
+                    const std::string &obsolete_path, std::string data );
+        /** Blocks until all queued writes are on disk. */
+        void flush();
+        /** Drops all staged and queued reads, e.g. because another world is loaded. */
+        void clear_staged();
+        /** Returns (and forgets) the paths that could not be written since the last call. */
+        std::vector<std::string> take_failed_writes();
+
+    private:
+        struct impl;
+        std::unique_ptr<impl> pimpl;
+};
+
+#endif
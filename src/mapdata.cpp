@@ -898,6 +898,11 @@ size_t ter_t::count()
     return terrain_data.size();
 }
 
+size_t furn_t::count()
+{
+    return furnlist.size();
+}
+
 void ter_t::load( JsonObject &jo )
 {
     mandatory( jo, was_loaded, "name", name );
@@ -298,6 +298,8 @@ struct furn_t : map_data_common_t {
     const itype *crafting_pseudo_item_type() const;
     // May return NULL
     const itype *crafting_ammo_item_type() const;
+
+    static size_t count();
 };
 
 
@@ -31,7 +31,15 @@
 #include <cassert>
 #include <list>
 #include <sstream>
+#include <fstream>
+#include <unordered_map>
+#include <set>
 #include "json.h"
+#include "filesystem.h"
+#include "snapshot.h"
+#include "init.h"
+#include "get_version.h"
+#include "path_info.h"
 #include "coordinates.h"
 #include "npc.h"
 #include "vehicle.h"
@@ -236,10 +244,117 @@ std::map<std::string, std::vector<mapgen_function*> > oter_mapgen;
  */
 std::map<std::string, std::map<int, int> > oter_mapgen_weights;
 
+/** Bump this when the layout of the snapshot or what the json mapgen pieces load changes. */
+static const uint32_t mapgen_snapshot_version = 1;
+
+/**
+ * The json mapgen functions that @ref calculate_mapgen_weights sets up, each only once. The order
+ * only depends on the loaded data.
+ */
+static std::vector<mapgen_function_json *> json_mapgen_functions()
+{
+    std::vector<mapgen_function_json *> result;
+    std::set<const mapgen_function *> seen;
+    for( auto &elem : oter_mapgen ) {
+        for( auto &func : elem.second ) {
+            const auto json_func = dynamic_cast<mapgen_function_json *>( func );
+            if( json_func != nullptr && json_func->weight >= 1 && seen.insert( json_func ).second ) {
+                result.push_back( json_func );
+            }
+        }
+    }
+    return result;
+}
+
+void write_mapgen_snapshot( std::ostream &fout, const uint64_t key )
+{
+    const auto functions = json_mapgen_functions();
+    snapshot_out out( fout );
+    out.write( mapgen_snapshot_version );
+    out.write( key );
+    out.write( static_cast<uint32_t>( functions.size() ) );
+    for( auto &func : functions ) {
+        out.write( func->jdata_hash );
+        func->write_snapshot( out );
+    }
+}
+
+bool read_mapgen_snapshot( std::istream &fin, const uint64_t key )
+{
+    const auto functions = json_mapgen_functions();
+    size_t restored = 0;
+    try {
+        snapshot_in in( fin );
+        if( in.read<uint32_t>() != mapgen_snapshot_version || in.read<uint64_t>() != key ) {
+            return false;
+        }
+        const uint32_t count = in.read<uint32_t>();
+        // The key covers the loaded data, so the functions come in the same order. Checking the
+        // hash of each one anyway is cheap compared to parsing them.
+        while( restored < count && restored < functions.size() ) {
+            mapgen_function_json &func = *functions[restored];
+            if( in.read<uint64_t>() != func.jdata_hash ) {
+                break;
+            }
+            func.read_snapshot( in );
+            restored++;
+        }
+    } catch( const snapshot_error &err ) {
+        dbg( D_WARNING ) << "broken mapgen snapshot: " << err.what();
+    }
+    return restored == functions.size();
+}
+
+/**
+ * What the snapshot is derived from besides the json mapgen functions themselves: the loaded data
+ * (item groups and so on are checked against it, int ids depend on it), the game version (enum
+ * values, what the pieces load) and the world options that are applied while loading. Format
+ * changes in a build that keeps its version string are covered by @ref mapgen_snapshot_version.
+ */
+static uint64_t mapgen_snapshot_key()
+{
+    content_hash hash;
+    hash.add( std::string( getVersionString() ) );
+    const uint64_t data_hash = DynamicDataLoader::get_instance().data_hash();
+    hash.add( reinterpret_cast<const char *>( &data_hash ), sizeof( data_hash ) );
+    const float item_spawn_rate = ACTIVE_WORLD_OPTIONS[ "ITEM_SPAWNRATE" ];
+    hash.add( reinterpret_cast<const char *>( &item_spawn_rate ), sizeof( item_spawn_rate ) );
+    return hash.value();
+}
+
+static void save_mapgen_snapshot( const std::string &path, const uint64_t key )
+{
+    for( auto &func : json_mapgen_functions() ) {
+        if( !func->is_ready ) {
+            // Not cached, so the error about the broken function shows up on each start.
+            return;
+        }
+    }
+    // Written to a temporary file, so that a crash does not leave a truncated snapshot.
+    const std::string temp_path = path + ".tmp";
+    std::ofstream fout( temp_path.c_str(), std::ios::binary | std::ios::trunc );
+    if( !fout ) {
+        dbg( D_WARNING ) << "could not write the mapgen snapshot to " << temp_path;
+        return;
+    }
+    write_mapgen_snapshot( fout, key );
+    fout.close();
+    if( !fout || !rename_file( temp_path, path ) ) {
+        dbg( D_WARNING ) << "could not write the mapgen snapshot to " << path;
+        remove_file( temp_path );
+    }
+}
+
 /*
  * setup oter_mapgen_weights which which mapgen uses to diceroll. Also setup mapgen_function_json
  */
 void calculate_mapgen_weights() { // todo; rename as it runs jsonfunction setup too
+    const std::string &snapshot_path = FILENAMES["mapgen_snapshot"];
+    const uint64_t snapshot_key = mapgen_snapshot_key();
+    std::ifstream snapshot( snapshot_path.c_str(), std::ios::binary );
+    const bool snapshot_valid = snapshot && read_mapgen_snapshot( snapshot, snapshot_key );
+    snapshot.close();
+
     oter_mapgen_weights.clear();
     for( std::map<std::string, std::vector<mapgen_function*> >::const_iterator oit = oter_mapgen.begin(); oit != oter_mapgen.end(); ++oit ) {
         int funcnum = 0;
@@ -265,6 +380,10 @@ void calculate_mapgen_weights() { // todo; rename as it runs jsonfunction setup
             funcnum++;
         }
     }
+
+    if( !snapshot_valid ) {
+        save_mapgen_snapshot( snapshot_path, snapshot_key );
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -415,6 +534,7 @@ bool mapgen_function_json::check_inbounds( const jmapgen_int & var ) const {
 mapgen_function_json::mapgen_function_json( std::string s, int const w )
 : mapgen_function( w )
 , jdata( std::move( s ) )
+, jdata_hash( 0 )
 , mapgensize( 24 )
 , fill_ter( t_null )
 , format()
@@ -424,6 +544,9 @@ mapgen_function_json::mapgen_function_json( std::string s, int const w )
 , objects()
 , rotation( 0 )
 {
+    content_hash hash;
+    hash.add( jdata );
+    jdata_hash = hash.value();
 }
 
 #define inboundchk(v,j) if (! check_inbounds(v) ) { j.throw_error(string_format("Value must be between 0 and %d",mapgensize)); }
@@ -464,11 +587,23 @@ jmapgen_int::jmapgen_int( JsonObject &jo, const std::string &tag, const short de
     }
 }
 
+jmapgen_int::jmapgen_int( snapshot_in &in )
+: val( in.read<short>() )
+, valmax( in.read<short>() )
+{
+}
+
 int jmapgen_int::get() const
 {
     return val == valmax ? val : rng( val, valmax );
 }
 
+void jmapgen_int::write( snapshot_out &out ) const
+{
+    out.write( val );
+    out.write( valmax );
+}
+
 /*
  * Turn json gobbldigook into machine friendly gobbldigook, for applying
  * basic map 'set' functions, optionally based on one_in(chance) or repeat value
@@ -578,6 +713,90 @@ jmapgen_place::jmapgen_place( JsonObject &jsi )
 {
 }
 
+jmapgen_place::jmapgen_place( snapshot_in &in )
+: x( in )
+, y( in )
+, repeat( in )
+{
+}
+
+void jmapgen_place::write( snapshot_out &out ) const
+{
+    x.write( out );
+    y.write( out );
+    repeat.write( out );
+}
+
+jmapgen_setmap::jmapgen_setmap( snapshot_in &in )
+: x( in )
+, y( in )
+, x2( in )
+, y2( in )
+, op( in.read<jmapgen_setmap_op>() )
+, val( in )
+, chance( in.read<int>() )
+, repeat( in )
+, rotation( in.read<int>() )
+, fuel( in.read<int>() )
+, status( in.read<int>() )
+{
+}
+
+void jmapgen_setmap::write( snapshot_out &out ) const
+{
+    x.write( out );
+    y.write( out );
+    x2.write( out );
+    y2.write( out );
+    out.write( op );
+    val.write( out );
+    out.write( chance );
+    repeat.write( out );
+    out.write( rotation );
+    out.write( fuel );
+    out.write( status );
+}
+
+/**
+ * Identifies the type of a @ref jmapgen_piece in the mapgen snapshot.
+ */
+enum class jmapgen_piece_tag : uint8_t {
+    field,
+    npc,
+    sign,
+    vending_machine,
+    toilet,
+    gaspump,
+    liquid_item,
+    item_group,
+    loot,
+    monster_group,
+    monster,
+    vehicle,
+    spawn_item,
+    trap,
+    furniture,
+    terrain,
+    make_rubble,
+    trap_alternatives,
+    furniture_alternatives,
+    terrain_alternatives,
+};
+
+template<typename PieceType>
+jmapgen_piece_tag alternatives_tag();
+
+/** Reads an int id written by the snapshot, there are @p count valid ids of that type. */
+template<typename T>
+static int_id<T> read_int_id( snapshot_in &in, const size_t count )
+{
+    const int id = in.read<int>();
+    if( id < 0 || static_cast<size_t>( id ) >= count ) {
+        throw snapshot_error( "invalid id" );
+    }
+    return int_id<T>( id );
+}
+
 /**
  * This is a generic mapgen piece, the template parameter PieceType should be another specific
  * type of jmapgen_piece. This class contains a vector of those objects and will chose one of
@@ -590,6 +809,25 @@ public:
     // PieceType, they *can not* be of any other type.
     std::vector<PieceType> alternatives;
     jmapgen_alternativly() = default;
+    jmapgen_alternativly( snapshot_in &in ) : jmapgen_piece()
+    {
+        const uint32_t count = in.read_size();
+        alternatives.reserve( count );
+        for( uint32_t i = 0; i < count; i++ ) {
+            alternatives.emplace_back( in );
+        }
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return alternatives_tag<PieceType>();
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( static_cast<uint32_t>( alternatives.size() ) );
+        for( auto &alternative : alternatives ) {
+            alternative.write( out );
+        }
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float mon_density ) const override
     {
         if( alternatives.empty() ) {
@@ -620,6 +858,25 @@ public:
             jsi.throw_error( "invalid field type", "field" );
         }
     }
+    jmapgen_field( snapshot_in &in ) : jmapgen_piece()
+    , ftype( in.read<field_id>() )
+    , density( in.read<int>() )
+    , age( in.read<int>() )
+    {
+        if( ftype <= fd_null || ftype >= num_fields ) {
+            throw snapshot_error( "invalid field type" );
+        }
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::field;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( ftype );
+        out.write( density );
+        out.write( age );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         m.add_field( tripoint( x.get(), y.get(), m.get_abs_sub().z ), ftype, density, age );
@@ -639,6 +896,18 @@ public:
             jsi.throw_error( "unknown npc class", "class" );
         }
     }
+    jmapgen_npc( snapshot_in &in ) : jmapgen_piece()
+    , npc_class( in.read<std::string>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::npc;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( npc_class );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         m.place_npc( x.get(), y.get(), npc_class );
@@ -660,6 +929,20 @@ public:
             jsi.throw_error("jmapgen_sign: needs either signage or snippet");
         }
     }
+    jmapgen_sign( snapshot_in &in ) : jmapgen_piece()
+    , signage( in.read<std::string>() )
+    , snippet( in.read<std::string>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::sign;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( signage );
+        out.write( snippet );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         const int rx = x.get();
@@ -711,6 +994,18 @@ public:
             jsi.throw_error( "no such item group", "item_group" );
         }
     }
+    jmapgen_vending_machine( snapshot_in &in ) : jmapgen_piece()
+    , item_group_id( in.read<std::string>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::vending_machine;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( item_group_id );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         const int rx = x.get();
@@ -730,6 +1025,18 @@ public:
     , amount( jsi, "amount", 0, 0 )
     {
     }
+    jmapgen_toilet( snapshot_in &in ) : jmapgen_piece()
+    , amount( in )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::toilet;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        amount.write( out );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         const int rx = x.get();
@@ -763,6 +1070,20 @@ public:
             }
         }
     }
+    jmapgen_gaspump( snapshot_in &in ) : jmapgen_piece()
+    , amount( in )
+    , fuel( in.read<std::string>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::gaspump;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        amount.write( out );
+        out.write( fuel );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         const int rx = x.get();
@@ -800,6 +1121,22 @@ public:
             jsi.throw_error( "no such item type", "liquid" );
         }
     }
+    jmapgen_liquid_item( snapshot_in &in ) : jmapgen_piece()
+    , amount( in )
+    , liquid( in.read<std::string>() )
+    , chance( in )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::liquid_item;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        amount.write( out );
+        out.write( liquid );
+        chance.write( out );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         if ( one_in(chance.get()) ){
@@ -829,6 +1166,20 @@ public:
             jsi.throw_error( "no such item group", "item" );
         }
     }
+    jmapgen_item_group( snapshot_in &in ) : jmapgen_piece()
+    , group_id( in.read<std::string>() )
+    , chance( in )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::item_group;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( group_id );
+        chance.write( out );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         m.place_items( group_id, chance.get(), x.val, y.val, x.valmax, y.valmax, true, 0 );
@@ -864,6 +1215,26 @@ class jmapgen_loot : public jmapgen_piece {
             }
         }
 
+        jmapgen_loot( snapshot_in &in ) : jmapgen_piece()
+        , group( in.read<std::string>() )
+        , name( in.read<std::string>() )
+        , chance( in.read<int>() )
+        , ammo( in.read<int>() )
+        , magazine( in.read<int>() )
+        {
+        }
+        jmapgen_piece_tag snapshot_tag() const override
+        {
+            return jmapgen_piece_tag::loot;
+        }
+        void write( snapshot_out &out ) const override
+        {
+            out.write( group );
+            out.write( name );
+            out.write( chance );
+            out.write( ammo );
+            out.write( magazine );
+        }
         void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
         {
             if( rng( 0, 99 ) < chance ) {
@@ -914,6 +1285,22 @@ public:
             jsi.throw_error( "no such monster group", "monster" );
         }
     }
+    jmapgen_monster_group( snapshot_in &in ) : jmapgen_piece()
+    , id( in.read<std::string>() )
+    , density( in.read<float>() )
+    , chance( in )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::monster_group;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( id.str() );
+        out.write( density );
+        chance.write( out );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float mdensity ) const override
     {
         m.place_spawns( id, chance.get(), x.val, y.val, x.valmax, y.valmax, density == -1.0f ? mdensity : density );
@@ -939,6 +1326,22 @@ public:
             jsi.throw_error( "no such monster", "monster" );
         }
     }
+    jmapgen_monster( snapshot_in &in ) : jmapgen_piece()
+    , id( in.read<std::string>() )
+    , friendly( in.read<bool>() )
+    , name( in.read<std::string>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::monster;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( id.str() );
+        out.write( friendly );
+        out.write( name );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mdensity*/ ) const override
     {
         m.add_spawn( id, 1, x.get(), y.get(), friendly, -1, -1, name );
@@ -978,6 +1381,26 @@ public:
             jsi.throw_error( "no such vehicle type or group", "vehicle" );
         }
     }
+    jmapgen_vehicle( snapshot_in &in ) : jmapgen_piece()
+    , type( in.read<std::string>() )
+    , chance( in )
+    , rotation( in.read_vector<int>() )
+    , fuel( in.read<int>() )
+    , status( in.read<int>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::vehicle;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( type.str() );
+        chance.write( out );
+        out.write( rotation );
+        out.write( fuel );
+        out.write( status );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         if( !x_in_y( chance.get(), 100 ) ) {
@@ -1006,6 +1429,22 @@ public:
             jsi.throw_error( "no such item type", "item" );
         }
     }
+    jmapgen_spawn_item( snapshot_in &in ) : jmapgen_piece()
+    , type( in.read<std::string>() )
+    , amount( in )
+    , chance( in )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::spawn_item;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( type );
+        amount.write( out );
+        chance.write( out );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         const int c = chance.get();
@@ -1040,6 +1479,18 @@ public:
         }
         id = sid.id();
     }
+    jmapgen_trap( snapshot_in &in ) : jmapgen_piece()
+    , id( read_int_id<trap>( in, trap::count() ) )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::trap;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( id.to_i() );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mdensity*/ ) const override
     {
         const tripoint actual_loc = tripoint( x.get(), y.get(), m.get_abs_sub().z );
@@ -1071,6 +1522,18 @@ public:
         }
         id = iter->second.loadid;
     }
+    jmapgen_furniture( snapshot_in &in ) : jmapgen_piece()
+    , id( read_int_id<furn_t>( in, furn_t::count() ) )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::furniture;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( id.to_i() );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mdensity*/ ) const override
     {
         m.furn_set( x.get(), y.get(), id );
@@ -1086,6 +1549,18 @@ public:
     jmapgen_terrain( JsonObject &jsi ) : jmapgen_terrain( jsi.get_string( "ter" ) ) {}
 
     jmapgen_terrain( const std::string &ter_name ) : jmapgen_piece(), id( ter_id( ter_name ) ) {}
+    jmapgen_terrain( snapshot_in &in ) : jmapgen_piece()
+    , id( read_int_id<ter_t>( in, ter_t::count() ) )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::terrain;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( id.to_i() );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mdensity*/ ) const override
     {
         m.ter_set( x.get(), y.get(), id );
@@ -1116,17 +1591,142 @@ public:
         }
         jsi.read( "overwrite", overwrite );
     }
+    jmapgen_make_rubble( snapshot_in &in ) : jmapgen_piece()
+    , rubble_type( read_int_id<furn_t>( in, furn_t::count() ) )
+    , items( in.read<bool>() )
+    , floor_type( read_int_id<ter_t>( in, ter_t::count() ) )
+    , overwrite( in.read<bool>() )
+    {
+    }
+    jmapgen_piece_tag snapshot_tag() const override
+    {
+        return jmapgen_piece_tag::make_rubble;
+    }
+    void write( snapshot_out &out ) const override
+    {
+        out.write( rubble_type.to_i() );
+        out.write( items );
+        out.write( floor_type.to_i() );
+        out.write( overwrite );
+    }
     void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, const float /*mon_density*/ ) const override
     {
         m.make_rubble( tripoint( x.get(), y.get(), m.get_abs_sub().z ), rubble_type, items, floor_type, overwrite );
     }
 };
 
+template<>
+jmapgen_piece_tag alternatives_tag<jmapgen_trap>()
+{
+    return jmapgen_piece_tag::trap_alternatives;
+}
+
+template<>
+jmapgen_piece_tag alternatives_tag<jmapgen_furniture>()
+{
+    return jmapgen_piece_tag::furniture_alternatives;
+}
+
+template<>
+jmapgen_piece_tag alternatives_tag<jmapgen_terrain>()
+{
+    return jmapgen_piece_tag::terrain_alternatives;
+}
+
+static std::shared_ptr<jmapgen_piece> read_jmapgen_piece( snapshot_in &in )
+{
+    switch( in.read<jmapgen_piece_tag>() ) {
+        case jmapgen_piece_tag::field:
+            return std::make_shared<jmapgen_field>( in );
+        case jmapgen_piece_tag::npc:
+            return std::make_shared<jmapgen_npc>( in );
+        case jmapgen_piece_tag::sign:
+            return std::make_shared<jmapgen_sign>( in );
+        case jmapgen_piece_tag::vending_machine:
+            return std::make_shared<jmapgen_vending_machine>( in );
+        case jmapgen_piece_tag::toilet:
+            return std::make_shared<jmapgen_toilet>( in );
+        case jmapgen_piece_tag::gaspump:
+            return std::make_shared<jmapgen_gaspump>( in );
+        case jmapgen_piece_tag::liquid_item:
+            return std::make_shared<jmapgen_liquid_item>( in );
+        case jmapgen_piece_tag::item_group:
+            return std::make_shared<jmapgen_item_group>( in );
+        case jmapgen_piece_tag::loot:
+            return std::make_shared<jmapgen_loot>( in );
+        case jmapgen_piece_tag::monster_group:
+            return std::make_shared<jmapgen_monster_group>( in );
+        case jmapgen_piece_tag::monster:
+            return std::make_shared<jmapgen_monster>( in );
+        case jmapgen_piece_tag::vehicle:
+            return std::make_shared<jmapgen_vehicle>( in );
+        case jmapgen_piece_tag::spawn_item:
+            return std::make_shared<jmapgen_spawn_item>( in );
+        case jmapgen_piece_tag::trap:
+            return std::make_shared<jmapgen_trap>( in );
+        case jmapgen_piece_tag::furniture:
+            return std::make_shared<jmapgen_furniture>( in );
+        case jmapgen_piece_tag::terrain:
+            return std::make_shared<jmapgen_terrain>( in );
+        case jmapgen_piece_tag::make_rubble:
+            return std::make_shared<jmapgen_make_rubble>( in );
+        case jmapgen_piece_tag::trap_alternatives:
+            return std::make_shared<jmapgen_alternativly<jmapgen_trap>>( in );
+        case jmapgen_piece_tag::furniture_alternatives:
+            return std::make_shared<jmapgen_alternativly<jmapgen_furniture>>( in );
+        case jmapgen_piece_tag::terrain_alternatives:
+            return std::make_shared<jmapgen_alternativly<jmapgen_terrain>>( in );
+    }
+    throw snapshot_error( "invalid mapgen piece" );
+}
+
 void jmapgen_objects::add(const jmapgen_place &place, std::shared_ptr<jmapgen_piece> &piece)
 {
     objects.emplace_back(place, piece);
 }
 
+void jmapgen_objects::write( snapshot_out &out ) const
+{
+    // The pieces from the format placings are shared by all places with their character.
+    std::vector<const jmapgen_piece *> pieces;
+    std::unordered_map<const jmapgen_piece *, uint32_t> indices;
+    for( auto &obj : objects ) {
+        if( indices.emplace( obj.second.get(), pieces.size() ).second ) {
+            pieces.push_back( obj.second.get() );
+        }
+    }
+    out.write( static_cast<uint32_t>( pieces.size() ) );
+    for( auto &piece : pieces ) {
+        out.write( piece->snapshot_tag() );
+        piece->write( out );
+    }
+    out.write( static_cast<uint32_t>( objects.size() ) );
+    for( auto &obj : objects ) {
+        obj.first.write( out );
+        out.write( indices[obj.second.get()] );
+    }
+}
+
+void jmapgen_objects::read( snapshot_in &in )
+{
+    std::vector<std::shared_ptr<jmapgen_piece>> pieces( in.read_size() );
+    for( auto &piece : pieces ) {
+        piece = read_jmapgen_piece( in );
+    }
+    std::vector<jmapgen_obj> result;
+    const uint32_t count = in.read_size();
+    result.reserve( count );
+    for( uint32_t i = 0; i < count; i++ ) {
+        const jmapgen_place where( in );
+        const uint32_t index = in.read<uint32_t>();
+        if( index >= pieces.size() ) {
+            throw snapshot_error( "invalid mapgen piece index" );
+        }
+        result.emplace_back( where, pieces[index] );
+    }
+    objects = std::move( result );
+}
+
 template<typename PieceType>
 void jmapgen_objects::load_objects( JsonArray parray )
 {
@@ -1325,7 +1925,9 @@ bool mapgen_function_json::setup() {
     if ( jdata.empty() ) {
         return false;
     }
-    std::istringstream iss( jdata );
+    // Parsed in place, jdata can be large and there are hundreds of these.
+    memory_streambuf buffer( jdata.data(), jdata.size() );
+    std::istream iss( &buffer );
     try {
         JsonIn jsin(iss);
         jsin.eat_whitespace();
@@ -1502,6 +2104,62 @@ bool mapgen_function_json::setup() {
     return true;
 }
 
+void mapgen_function_json::write_snapshot( snapshot_out &out ) const
+{
+    out.write( static_cast<uint32_t>( mapgensize ) );
+    out.write( fill_ter.to_i() );
+    out.write( static_cast<uint32_t>( format.size() ) );
+    for( auto &elem : format ) {
+        out.write( elem.ter.to_i() );
+        out.write( elem.furn.to_i() );
+    }
+    out.write( static_cast<uint32_t>( setmap_points.size() ) );
+    for( auto &elem : setmap_points ) {
+        elem.write( out );
+    }
+    out.write( luascript );
+    out.write( do_format );
+    objects.write( out );
+    rotation.write( out );
+}
+
+void mapgen_function_json::read_snapshot( snapshot_in &in )
+{
+    // Read into locals first, so nothing changes if the snapshot turns out to be broken.
+    const size_t new_mapgensize = in.read<uint32_t>();
+    const ter_id new_fill_ter = read_int_id<ter_t>( in, ter_t::count() );
+    std::vector<ter_furn_id> new_format( in.read_size() );
+    if( new_format.size() != new_mapgensize * new_mapgensize ) {
+        throw snapshot_error( "format does not match the map size" );
+    }
+    for( auto &elem : new_format ) {
+        elem.ter = read_int_id<ter_t>( in, ter_t::count() );
+        elem.furn = read_int_id<furn_t>( in, furn_t::count() );
+    }
+    std::vector<jmapgen_setmap> new_setmap_points;
+    const uint32_t setmap_count = in.read_size();
+    new_setmap_points.reserve( setmap_count );
+    for( uint32_t i = 0; i < setmap_count; i++ ) {
+        new_setmap_points.emplace_back( in );
+    }
+    std::string new_luascript = in.read<std::string>();
+    const bool new_do_format = in.read<bool>();
+    jmapgen_objects new_objects;
+    new_objects.read( in );
+    const jmapgen_int new_rotation( in );
+
+    mapgensize = new_mapgensize;
+    fill_ter = new_fill_ter;
+    format = std::move( new_format );
+    setmap_points = std::move( new_setmap_points );
+    luascript = std::move( new_luascript );
+    do_format = new_do_format;
+    objects = std::move( new_objects );
+    rotation = new_rotation;
+    jdata.clear();
+    is_ready = true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 ///// 3 - mapgen (gameplay)
 ///// stuff below is the actual in-game mapgeneration (ill)logic
@@ -8820,7 +9478,7 @@ FFFFFFFFFFFFFFFFFFFFFFFF\n\
         for(int a = 0; a < 21; a++ ) {
             vset.push_back(a);
         }
-        std::random_shuffle(vset.begin(), vset.end());
+        std::shuffle( vset.begin(), vset.end(), rng_context::current() );
         for(int a = 0; a < vnum; a++) {
             if (vset[a] < 12) {
                 if (one_in(2)) {
@@ -9023,7 +9681,7 @@ FFFFFFFFFFFFFFFFFFFFFFFF\n\
         for(int a = 0; a < 17; a++) {
             vset.push_back(a);
         }
-        std::random_shuffle(vset.begin(), vset.end());
+        std::shuffle( vset.begin(), vset.end(), rng_context::current() );
         for(int a = 0; a < vnum; a++) {
             if (vset[a] < 3) {
                 if (one_in(2)) {
@@ -11035,6 +11693,9 @@ void map::rotate(int turns)
             std::swap( furnrot[i][j], sm->frn[lx][ly] );
             std::swap( traprot[i][j], sm->trp[lx][ly] );
             std::swap( fldrot[i][j], sm->fld[lx][ly] );
+            if( sm->fld[lx][ly].fieldCount() > 0 ) {
+                sm->mark_field_tile( lx, ly );
+            }
             std::swap( radrot[i][j], sm->rad[lx][ly] );
             std::swap( cosmetics_rot[i][j], sm->cosmetics[lx][ly] );
             for( auto &itm : itrot[i][j] ) {
@@ -1,6 +1,8 @@
 #ifndef MAPGEN_H
 #define MAPGEN_H
 
+#include <cstdint>
+#include <iosfwd>
 #include <map>
 #include <string>
 #include <memory>
@@ -9,6 +11,8 @@
 
 struct oter_id;
 struct mapgendata;
+class snapshot_in;
+class snapshot_out;
 typedef void (*building_gen_pointer)(map *,oter_id,mapgendata,int,float);
 
 //////////////////////////////////////////////////////////////////////////
@@ -57,8 +61,10 @@ struct jmapgen_int {
      * if the member is just missing (the default values are used instead).
      */
     jmapgen_int( JsonObject &jso, const std::string &key, short def_val, short def_valmax );
+    jmapgen_int( snapshot_in &in );
 
     int get() const;
+    void write( snapshot_out &out ) const;
 };
 
 enum jmapgen_setmap_op {
@@ -102,7 +108,9 @@ struct jmapgen_setmap {
     ) :
        x(ix), y(iy), x2(ix2), y2(iy2), op(iop), val(ival), chance(ione_in), repeat(irepeat), rotation(irotation),
        fuel(ifuel), status(istatus) {}
+    jmapgen_setmap( snapshot_in &in );
     bool apply( map * m );
+    void write( snapshot_out &out ) const;
 };
 
 /**
@@ -122,16 +130,25 @@ struct jmapgen_setmap {
  *    a new line with your class there. It should look like
  *    @code load_place_mapings<your_own_class_from_step_1>( jo, "something", format_placings ); @endcode
  *    Using the same "something" as in step 2 is preferred.
+ * 4. Add a tag for your class to @ref jmapgen_piece_tag and to read_jmapgen_piece, give the class a
+ *    constructor that accepts a @ref snapshot_in and implement @ref write, which must write the
+ *    members in the same order the constructor reads them. Bump mapgen_snapshot_version.
  *
  * For actual examples look at the commits that introduced the load_objects/load_place_mapings
  * lines (ignore the changes to the json files).
  */
+enum class jmapgen_piece_tag : uint8_t;
+
 class jmapgen_piece {
 protected:
     jmapgen_piece() { }
 public:
     /** Place something on the map m at (x,y). mon_density */
     virtual void apply( map &m, const jmapgen_int &x, const jmapgen_int &y, float mon_density ) const = 0;
+    /** Identifies the class in the mapgen snapshot, see @ref write_mapgen_snapshot. */
+    virtual jmapgen_piece_tag snapshot_tag() const = 0;
+    /** Writes the members for the mapgen snapshot, they are read back by a constructor. */
+    virtual void write( snapshot_out &out ) const = 0;
     virtual ~jmapgen_piece() { }
 };
 
@@ -143,6 +160,8 @@ public:
     jmapgen_place() : x( 0, 0 ), y( 0, 0 ), repeat( 1, 1 ) { }
     jmapgen_place(const int a, const int b) : x( a ), y( b ), repeat( 1, 1 ) { }
     jmapgen_place( JsonObject &jsi );
+    jmapgen_place( snapshot_in &in );
+    void write( snapshot_out &out ) const;
     jmapgen_int x;
     jmapgen_int y;
     jmapgen_int repeat;
@@ -169,6 +188,10 @@ struct jmapgen_objects {
 
     void apply(map* m, float density) const;
 
+    /** Pieces placed at several places are only written once. */
+    void write( snapshot_out &out ) const;
+    void read( snapshot_in &in );
+
 private:
     /**
      * Combination of where to place something and what to place.
@@ -188,9 +211,19 @@ class mapgen_function_json : public virtual mapgen_function {
     ~mapgen_function_json() {
     }
 
+    /** Writes what @ref setup loaded from @ref jdata, must only be called after it. */
+    void write_snapshot( snapshot_out &out ) const;
+    /**
+     * Restores what @ref write_snapshot wrote, as if @ref setup had been called.
+     * @throws snapshot_error if the data is broken, the function is unchanged then.
+     */
+    void read_snapshot( snapshot_in &in );
+
     size_t calc_index( size_t x, size_t y ) const;
 
     std::string jdata;
+    /** Hash of @ref jdata, to tell whether a snapshot of this function is still valid. */
+    uint64_t jdata_hash;
     size_t mapgensize;
     ter_id fill_ter;
     std::vector<ter_furn_id> format;
@@ -255,6 +288,20 @@ extern std::map<std::string, std::map<int, int> > oter_mapgen_weights;
  */
 void calculate_mapgen_weights();
 
+/**
+ * Parsing the json mapgen functions takes a good part of the loading time. What they loaded is
+ * kept in a binary snapshot (see @ref mapgen_function_json::write_snapshot), and the next start
+ * with the same data restores them from that instead. Snapshots are only valid for the given key,
+ * which @ref calculate_mapgen_weights derives from the loaded data, the build and the world options.
+ */
+void write_mapgen_snapshot( std::ostream &fout, uint64_t key );
+/**
+ * Restores the json mapgen functions that have not changed since the snapshot was written.
+ * Functions that are not in the snapshot are left alone (their @ref mapgen_function::setup
+ * parses the JSON as usual). Returns whether all functions were restored.
+ */
+bool read_mapgen_snapshot( std::istream &fin, uint64_t key );
+
 /// move to building_generation
 enum room_type {
     room_null,
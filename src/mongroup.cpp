@@ -10,6 +10,11 @@
 #include "monstergenerator.h"
 #include "json.h"
 #include "mtype.h"
+#include "line.h"
+#include "game_constants.h"
+
+#include <algorithm>
+#include <iterator>
 
 // Default start time, this is the only place it's still used.
 #define STARTING_MINUTES 480
@@ -59,6 +64,169 @@ void mongroup::clear() {
     monsters.clear();
 }
 
+constexpr int mongroup_grid::cell_size;
+
+mongroup_grid::mongroup_grid( const mongroup_grid &other )
+    : groups( other.groups )
+{
+    for( auto &group : groups ) {
+        add_to_cell( group );
+    }
+}
+
+mongroup_grid &mongroup_grid::operator=( const mongroup_grid &other )
+{
+    if( this != &other ) {
+        groups = other.groups;
+        cells.clear();
+        for( auto &group : groups ) {
+            add_to_cell( group );
+        }
+    }
+    return *this;
+}
+
+tripoint mongroup_grid::cell_of( const tripoint &p )
+{
+    // Round towards negative infinity, groups may be outside of the overmap.
+    const auto floor_div = []( int v ) {
+        return v >= 0 ? v / cell_size : ( v - cell_size + 1 ) / cell_size;
+    };
+    return tripoint( floor_div( p.x ), floor_div( p.y ), p.z );
+}
+
+void mongroup_grid::add_to_cell( mongroup &group )
+{
+    cells[cell_of( group.pos )].push_back( &group );
+}
+
+void mongroup_grid::remove_from_cell( const mongroup &group )
+{
+    const auto remove_from = [&group]( std::vector<mongroup *> &cell ) {
+        const auto iter = std::find( cell.begin(), cell.end(), &group );
+        if( iter == cell.end() ) {
+            return false;
+        }
+        *iter = cell.back();
+        cell.pop_back();
+        return true;
+    };
+    const auto cell_iter = cells.find( cell_of( group.pos ) );
+    if( cell_iter != cells.end() && remove_from( cell_iter->second ) ) {
+        if( cell_iter->second.empty() ) {
+            cells.erase( cell_iter );
+        }
+        return;
+    }
+    // Someone changed the position without telling us.
+    debugmsg( "monster group at %d,%d,%d is not in its grid cell", group.pos.x, group.pos.y,
+              group.pos.z );
+    for( auto iter = cells.begin(); iter != cells.end(); ++iter ) {
+        if( remove_from( iter->second ) ) {
+            if( iter->second.empty() ) {
+                cells.erase( iter );
+            }
+            return;
+        }
+    }
+}
+
+mongroup_grid::iterator mongroup_grid::insert( const mongroup &group )
+{
+    groups.push_back( group );
+    add_to_cell( groups.back() );
+    return std::prev( groups.end() );
+}
+
+mongroup_grid::iterator mongroup_grid::erase( iterator it )
+{
+    remove_from_cell( *it );
+    return groups.erase( it );
+}
+
+void mongroup_grid::move( iterator it, const tripoint &new_pos )
+{
+    mongroup &group = *it;
+    if( cell_of( group.pos ) != cell_of( new_pos ) ) {
+        remove_from_cell( group );
+        group.pos = new_pos;
+        add_to_cell( group );
+    } else {
+        group.pos = new_pos;
+    }
+}
+
+void mongroup_grid::clear()
+{
+    groups.clear();
+    cells.clear();
+}
+
+std::vector<mongroup *> mongroup_grid::at( const tripoint &p )
+{
+    std::vector<mongroup *> result;
+    const auto cell_iter = cells.find( cell_of( p ) );
+    if( cell_iter != cells.end() ) {
+        for( mongroup *group : cell_iter->second ) {
+            if( group->pos == p ) {
+                result.push_back( group );
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<const mongroup *> mongroup_grid::at( const tripoint &p ) const
+{
+    const auto found = const_cast<mongroup_grid *>( this )->at( p );
+    return std::vector<const mongroup *>( found.begin(), found.end() );
+}
+
+void mongroup_grid::for_each_in_radius( const tripoint &center, const int radius,
+                                        const std::function<void( mongroup & )> &func )
+{
+    if( radius < 0 ) {
+        return;
+    }
+    const tripoint min_cell = cell_of( tripoint( center.x - radius, center.y - radius,
+                                       std::max( center.z - radius, -OVERMAP_DEPTH ) ) );
+    const tripoint max_cell = cell_of( tripoint( center.x + radius, center.y + radius,
+                                       std::min( center.z + radius, OVERMAP_HEIGHT ) ) );
+    const auto visit = [&]( const std::vector<mongroup *> &cell ) {
+        for( mongroup *group : cell ) {
+            if( rl_dist( center, group->pos ) <= radius ) {
+                func( *group );
+            }
+        }
+    };
+
+    const size_t area = size_t( max_cell.x - min_cell.x + 1 ) * ( max_cell.y - min_cell.y + 1 ) *
+                        ( max_cell.z - min_cell.z + 1 );
+    if( area >= cells.size() ) {
+        // Fewer occupied cells than cells in the area, checking them all is cheaper.
+        for( const auto &elem : cells ) {
+            const tripoint &c = elem.first;
+            if( c.x >= min_cell.x && c.x <= max_cell.x && c.y >= min_cell.y && c.y <= max_cell.y &&
+                c.z >= min_cell.z && c.z <= max_cell.z ) {
+                visit( elem.second );
+            }
+        }
+        return;
+    }
+
+    tripoint c;
+    for( c.z = min_cell.z; c.z <= max_cell.z; c.z++ ) {
+        for( c.x = min_cell.x; c.x <= max_cell.x; c.x++ ) {
+            for( c.y = min_cell.y; c.y <= max_cell.y; c.y++ ) {
+                const auto iter = cells.find( c );
+                if( iter != cells.end() ) {
+                    visit( iter->second );
+                }
+            }
+        }
+    }
+}
+
 const MonsterGroup &MonsterGroupManager::GetUpgradedMonsterGroup( const mongroup_id& group )
 {
     const MonsterGroup *groupptr = &group.obj();
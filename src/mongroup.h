@@ -5,6 +5,9 @@
 #include <map>
 #include <set>
 #include <string>
+#include <list>
+#include <functional>
+#include <unordered_map>
 #include "enums.h"
 #include "json.h"
 #include "string_id.h"
@@ -154,6 +157,76 @@ struct mongroup : public JsonSerializer, public JsonDeserializer {
     void serialize( JsonOut &jsout ) const override;
 };
 
+/**
+ * Container for the monster groups of an overmap.
+ * The groups are bucketed into a coarse grid (by their @ref mongroup::pos) so that
+ * lookups by location or area only look at the groups nearby.
+ * Groups never move in memory: iterators and pointers to them stay valid until the
+ * group is erased. If the position of a stored group is changed, it must be done
+ * through @ref move, otherwise the group won't be found by location.
+ */
+class mongroup_grid
+{
+    public:
+        using container = std::list<mongroup>;
+        using iterator = container::iterator;
+        using const_iterator = container::const_iterator;
+
+        mongroup_grid() = default;
+        mongroup_grid( const mongroup_grid &other );
+        mongroup_grid( mongroup_grid && ) = default;
+        mongroup_grid &operator=( const mongroup_grid &other );
+        mongroup_grid &operator=( mongroup_grid && ) = default;
+
+        iterator insert( const mongroup &group );
+        /** Removes the group, returns the iterator following it. */
+        iterator erase( iterator it );
+        /** Changes the position of the group, it is not copied. */
+        void move( iterator it, const tripoint &new_pos );
+        void clear();
+
+        size_t size() const {
+            return groups.size();
+        }
+        bool empty() const {
+            return groups.empty();
+        }
+        iterator begin() {
+            return groups.begin();
+        }
+        iterator end() {
+            return groups.end();
+        }
+        const_iterator begin() const {
+            return groups.begin();
+        }
+        const_iterator end() const {
+            return groups.end();
+        }
+
+        /** Returns all groups located exactly at p. */
+        std::vector<mongroup *> at( const tripoint &p );
+        std::vector<const mongroup *> at( const tripoint &p ) const;
+        /**
+         * Calls func for each group within radius (in @ref rl_dist terms) of center.
+         * func must not insert, erase or move groups.
+         */
+        void for_each_in_radius( const tripoint &center, int radius,
+                                 const std::function<void( mongroup & )> &func );
+
+    private:
+        /** Size (in submaps) of a grid cell. */
+        static constexpr int cell_size = 8;
+        static tripoint cell_of( const tripoint &p );
+
+        container groups;
+        /** Groups in each grid cell, keys are from @ref cell_of. */
+        std::unordered_map<tripoint, std::vector<mongroup *>> cells;
+
+        void add_to_cell( mongroup &group );
+        void remove_from_cell( const mongroup &group );
+};
+
 class MonsterGroupManager
 {
     public:
@@ -18,6 +18,7 @@
 #include "mapdata.h"
 #include "mtype.h"
 #include "field.h"
+#include "creature_tracker.h"
 
 #include <stdlib.h>
 //Used for e^(x) functions
@@ -159,6 +160,9 @@ void monster::plan( const mfactions &factions )
     bool group_morale = has_flag( MF_GROUP_MORALE ) && morale < type->morale;
     bool swarms = has_flag( MF_SWARMS );
     auto mood = attitude();
+    // Nothing further away than this can be seen, so it can't be rated as a target either.
+    const int max_sight_range = std::max( 1, sight_range( DAYLIGHT_LEVEL ) );
+    const mfaction_id playerfaction = mfaction_str_id( "player" );
 
     // If we can see the player, move toward them or flee.
     if( friendly == 0 && sees( g->u ) ) {
@@ -171,15 +175,26 @@ void monster::plan( const mfactions &factions )
         }
     } else if( friendly != 0 && !docile ) {
         // Target unfriendly monsters, only if we aren't interacting with the player.
-        for( int i = 0, numz = g->num_zombies(); i < numz; i++ ) {
-            monster &tmp = g->zombie( i );
-            if( tmp.friendly == 0 ) {
-                float rating = rate_target( tmp, dist, electronic );
-                if( rating < dist ) {
-                    target = &tmp;
-                    dist = rating;
-                }
+        if( !electronic ) {
+            // The rating is just the distance, so the closest visible one is the best.
+            monster *const tmp = g->critter_tracker->find_nearest( pos(), max_sight_range,
+            [this]( const monster & other ) {
+                return other.friendly == 0 && sees( other );
+            } );
+            if( tmp != nullptr ) {
+                target = tmp;
+                dist = rl_dist( pos(), tmp->pos() );
             }
+        } else {
+            g->critter_tracker->for_each_in_radius( pos(), max_sight_range, [&]( monster & tmp ) {
+                if( tmp.friendly == 0 ) {
+                    float rating = rate_target( tmp, dist, electronic );
+                    if( rating < dist ) {
+                        target = &tmp;
+                        dist = rating;
+                    }
+                }
+            } );
         }
     }
 
@@ -211,30 +226,28 @@ void monster::plan( const mfactions &factions )
 
     fleeing = fleeing || ( mood == MATT_FLEE );
     if( friendly == 0 ) {
-        for( const auto &fac : factions ) {
-            auto faction_att = faction.obj().attitude( fac.first );
+        g->critter_tracker->for_each_in_radius( pos(), max_sight_range, [&]( monster & mon ) {
+            const mfaction_id &mon_faction = mon.friendly == 0 ? mon.faction : playerfaction;
+            auto faction_att = faction.obj().attitude( mon_faction );
             if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
-                continue;
+                return;
             }
 
-            for( int i : fac.second ) { // mon indices
-                monster &mon = g->zombie( i );
-                float rating = rate_target( mon, dist, electronic );
-                if( rating < dist ) {
-                    target = &mon;
-                    dist = rating;
-                }
-                if( rating <= 5 ) {
-                    anger += angers_hostile_near;
-                    morale -= fears_hostile_near;
-                }
+            float rating = rate_target( mon, dist, electronic );
+            if( rating < dist ) {
+                target = &mon;
+                dist = rating;
             }
-        }
+            if( rating <= 5 ) {
+                anger += angers_hostile_near;
+                morale -= fears_hostile_near;
+            }
+        } );
     }
 
     // Friendly monsters here
     // Avoid for hordes of same-faction stuff or it could get expensive
-    const auto actual_faction = friendly == 0 ? faction : mfaction_str_id( "player" );
+    const auto actual_faction = friendly == 0 ? faction : playerfaction;
     auto const &myfaction_iter = factions.find( actual_faction );
     if( myfaction_iter == factions.end() ) {
         DebugLog( D_ERROR, D_GAME ) << disp_name() << " tried to find faction "
@@ -244,8 +257,11 @@ void monster::plan( const mfactions &factions )
     }
     swarms = swarms && target == nullptr; // Only swarm if we have no target
     if( group_morale || swarms ) {
-        for( const int i : myfaction_iter->second ) {
-            monster &mon = g->zombie( i );
+        g->critter_tracker->for_each_in_radius( pos(), max_sight_range, [&]( monster & mon ) {
+            const mfaction_id &mon_faction = mon.friendly == 0 ? mon.faction : playerfaction;
+            if( mon_faction != actual_faction ) {
+                return;
+            }
             float rating = rate_target( mon, dist, electronic );
             if( group_morale && rating <= 10 ) {
                 morale += 10 - rating;
@@ -262,7 +278,7 @@ void monster::plan( const mfactions &factions )
                     dist = rating;
                 }
             }
-        }
+        } );
     }
 
     if( target != nullptr ) {
@@ -685,6 +701,29 @@ void monster::move()
             }
         }
     }
+    // Greedy steps walk into dead ends behind walls. When chasing a creature, steer by the
+    // distance field shared by everything chasing it if the greedy step makes no progress.
+    if( !wander() && destination == goal && goal.z == posz() && g->critter_at( goal ) != nullptr &&
+        ( !moved || ( next_step.z == posz() && can_move_to( next_step ) ) ) ) {
+        const distance_field &field = g->m.get_distance_field( goal );
+        const int cur_dist = field.at( pos() );
+        if( cur_dist > 0 && ( !moved || field.at( next_step ) < 0 ||
+                              field.at( next_step ) >= cur_dist ) ) {
+            int best_dist = cur_dist;
+            for( const tripoint &candidate : g->m.points_in_radius( pos(), 1 ) ) {
+                const int candidate_dist = field.at( candidate );
+                if( candidate_dist < 0 || candidate_dist >= best_dist ||
+                    g->critter_at( candidate, is_hallucination() ) != nullptr ||
+                    !can_move_to( candidate ) ) {
+                    continue;
+                }
+                best_dist = candidate_dist;
+                next_step = candidate;
+                moved = true;
+            }
+        }
+    }
+
     // Finished logic section.  By this point, we should have chosen a square to
     //  move to (moved = true).
     if( moved ) { // Actual effects of moving to the square we've chosen
@@ -1758,21 +1758,27 @@ void npc::find_item()
 
     static const std::string no_pickup( "NO_NPC_PICKUP" );
 
+    // Same as can_pickWeight( wgt, true ) and can_pickVolume( vol, true ), without
+    // summing up our inventory for every single item.
+    const int free_weight = weight_capacity() - weight_carried();
+    const int free_volume = volume_capacity() - volume_carried();
+
     const item *wanted = nullptr;
-    for( const tripoint &p : g->m.points_in_radius( pos(), range ) ) {
+    for( const tripoint &p : g->m.tiles_with_items( pos(), range ) ) {
         // TODO: Make this sight check not overdraw nearby tiles
         // TODO: Optimize that zone check
-        if( g->m.sees_some_items( p, *this ) && sees( p ) &&
+        if( g->m.could_see_items( p, *this ) && sees( p ) &&
             ( !is_following() || !g->check_zone( no_pickup, p ) ) ) {
             for( auto &elem : g->m.i_at( p ) ) {
                 if( elem.made_of( LIQUID ) ) {
                     // Don't even consider liquids.
                     continue;
                 }
+                if( elem.weight() > free_weight || elem.volume() > free_volume ) {
+                    continue;
+                }
                 int itval = value( elem );
-                int wgt = elem.weight(), vol = elem.volume();
-                if( itval > best_value &&
-                    ( can_pickWeight( wgt, true ) && can_pickVolume( vol, true ) ) ) {
+                if( itval > best_value ) {
                     wanted_item_pos = p;
                     wanted = &( elem );
                     best_value = itval;
@@ -822,6 +822,11 @@ void options_manager::init()
                                        0, 127, 5
                                       );
 
+    OPTIONS["BINARY_MAP_SAVES"] = cOpt("general", _("Binary map saves"),
+                                       _("If true, the map is saved in a binary format that loads faster, especially while travelling by vehicle. Existing map files are converted when they are saved again."),
+                                       false
+                                      );
+
     mOptionsSort["general"]++;
 
     OPTIONS["CIRCLEDIST"] = cOpt("general", _("Circular distances"),
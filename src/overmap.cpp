@@ -39,6 +39,8 @@
 #include <cstring>
 #include <ostream>
 #include <queue>
+#include <map>
+#include <memory>
 
 #define dbg(x) DebugLog((DebugLevel)(x),D_MAP_GEN) << __FILE__ << ":" << __LINE__ << ": "
 
@@ -945,19 +947,19 @@ bool overmap::is_explored(int const x, int const y, int const z) const
 
 bool overmap::mongroup_check(const mongroup &candidate) const
 {
-    const auto matching_range = zg.equal_range(candidate.pos);
-    return std::find_if( matching_range.first, matching_range.second,
-        [candidate](std::pair<tripoint, mongroup> match) {
+    const auto matching = zg.at( candidate.pos );
+    return std::find_if( matching.begin(), matching.end(),
+        [&candidate]( const mongroup *match ) {
             // This is extra strict since we're using it to test serialization.
-            return candidate.type == match.second.type && candidate.pos == match.second.pos &&
-                candidate.radius == match.second.radius &&
-                candidate.population == match.second.population &&
-                candidate.target == match.second.target &&
-                candidate.interest == match.second.interest &&
-                candidate.dying == match.second.dying &&
-                candidate.horde == match.second.horde &&
-                candidate.diffuse == match.second.diffuse;
-        } ) != matching_range.second;
+            return candidate.type == match->type && candidate.pos == match->pos &&
+                candidate.radius == match->radius &&
+                candidate.population == match->population &&
+                candidate.target == match->target &&
+                candidate.interest == match->interest &&
+                candidate.dying == match->dying &&
+                candidate.horde == match->horde &&
+                candidate.diffuse == match->diffuse;
+        } ) != matching.end();
 }
 
 int overmap::num_mongroups() const
@@ -1661,6 +1663,84 @@ static bool get_scent_glyph( const tripoint &pos, nc_color &ter_color, long &ter
     return false;
 }
 
+namespace {
+
+/** What overmap::draw shows for an overmap terrain when no overlay covers it. */
+struct om_tile_glyph {
+    bool seen = false;
+    bool explored = false;
+    bool has_note = false;
+    /** Only loaded if the terrain has been seen, ot_null otherwise. */
+    oter_id ter = ot_null;
+    long sym = ' ';
+    nc_color color = c_black;
+    long note_sym = 'N';
+    nc_color note_color = c_yellow;
+};
+
+/** The glyphs of one z-level of one overmap, filled as overmap::draw needs them. */
+struct om_glyph_layer {
+    std::vector<om_tile_glyph> tiles = std::vector<om_tile_glyph>( OMAPX * OMAPY );
+    std::vector<bool> valid = std::vector<bool>( OMAPX * OMAPY, false );
+};
+
+/**
+ * Glyph layers of the overmaps shown by overmap::draw_overmap, keyed by overmap
+ * position and z-level.
+ * Time doesn't pass while the overmap is shown, so terrain, seen / explored status
+ * and notes only change through the actions of the overmap screen itself, which call
+ * clear_om_glyph_cache afterwards.
+ */
+std::map<tripoint, std::unique_ptr<om_glyph_layer>> om_glyph_cache;
+
+void clear_om_glyph_cache()
+{
+    om_glyph_cache.clear();
+}
+
+const om_tile_glyph &get_om_glyph( const tripoint &omt )
+{
+    int x = omt.x;
+    int y = omt.y;
+    const point om = omt_to_om_remain( x, y );
+    auto &layer = om_glyph_cache[tripoint( om.x, om.y, omt.z )];
+    if( !layer ) {
+        layer.reset( new om_glyph_layer() );
+    }
+    const size_t index = x + y * OMAPX;
+    om_tile_glyph &glyph = layer->tiles[index];
+    if( layer->valid[index] ) {
+        return glyph;
+    }
+    layer->valid[index] = true;
+
+    glyph.seen = overmap_buffer.seen( omt.x, omt.y, omt.z );
+    if( overmap_buffer.has_note( omt ) ) {
+        glyph.has_note = true;
+        std::tie( glyph.note_sym, glyph.note_color, std::ignore ) =
+            get_note_display_info( overmap_buffer.note( omt ) );
+    }
+    if( !glyph.seen ) {
+        return glyph;
+    }
+    // Only load terrain if we can actually see it
+    glyph.ter = overmap_buffer.ter( omt );
+    const auto it = otermap.find( glyph.ter );
+    if( it == otermap.end() ) {
+        debugmsg( "Bad ter %s (%d, %d)", glyph.ter.c_str(), omt.x, omt.y );
+        glyph.color = c_red;
+        glyph.sym = '?';
+        // Keep it red even if it has been explored.
+        return glyph;
+    }
+    glyph.explored = overmap_buffer.is_explored( omt.x, omt.y, omt.z );
+    glyph.color = it->second.color;
+    glyph.sym = it->second.sym;
+    return glyph;
+}
+
+} // namespace
+
 void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
                    const tripoint &orig, bool blink, bool show_explored,
                    input_context *inp_ctxt, const draw_data_t &data)
@@ -1704,12 +1784,6 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
         }
     }
 
-    // A small LRU cache: most oter_id's occur in clumps like forests of swamps.
-    // This cache helps avoid much more costly lookups in the full hashmap.
-    constexpr size_t cache_size = 8; // used below to calculate the next index
-    std::array<std::pair<oter_id, oter_t const*>, cache_size> cache {{}};
-    size_t cache_next = 0;
-
     int const offset_x = cursx - om_half_width;
     int const offset_y = cursy - om_half_height;
 
@@ -1744,19 +1818,19 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
             const int omx = i + offset_x;
             const int omy = j + offset_y;
 
-            oter_id cur_ter = ot_null;
+            tripoint const cur_pos {omx, omy, z};
+            // Terrain, seen status and notes come from the glyph cache,
+            // only the overlays below are looked up for each frame.
+            const om_tile_glyph &glyph = get_om_glyph( cur_pos );
+            const bool see = glyph.seen;
+            const oter_id cur_ter = glyph.ter;
             nc_color ter_color = c_black;
             long ter_sym = ' ';
 
-            const bool see = overmap_buffer.seen(omx, omy, z);
-            if (see) {
-                // Only load terrain if we can actually see it
-                cur_ter = overmap_buffer.ter(omx, omy, z);
-            }
-
-            tripoint const cur_pos {omx, omy, z};
             // Check if location is within player line-of-sight
-            const bool los = see && g->u.overmap_los( cur_pos, sight_points );
+            const auto los = [&]() {
+                return see && g->u.overmap_los( cur_pos, sight_points );
+            };
 
             if (blink && cur_pos == orig) {
                 // Display player pos, should always be visible
@@ -1774,10 +1848,10 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
                 } else if( target.z < z ) {
                     ter_sym = 'v';
                 }
-            } else if (blink && overmap_buffer.has_note(cur_pos)) {
+            } else if (blink && glyph.has_note) {
                 // Display notes in all situations, even when not seen
-                std::tie(ter_sym, ter_color, std::ignore) =
-                    get_note_display_info(overmap_buffer.note(cur_pos));
+                ter_color = glyph.note_color;
+                ter_sym   = glyph.note_sym;
             } else if (!see) {
                 // All cases above ignore the seen-status,
                 ter_color = c_dkgray;
@@ -1787,7 +1861,7 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
                 // Display NPCs only when player can see the location
                 ter_color = c_pink;
                 ter_sym   = '@';
-            } else if (blink && los && overmap_buffer.has_horde(omx, omy, z)) {
+            } else if (blink && overmap_buffer.has_horde(omx, omy, z) && los()) {
                 // Display Hordes only when within player line-of-sight
                 ter_color = c_green;
                 ter_sym   = 'Z';
@@ -1800,35 +1874,9 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
                 ter_sym   = 'Z';
             } else {
                 // Nothing special, but is visible to the player.
-                // First see if we have the oter_t cached
-                oter_t const* info = nullptr;
-                for (auto const &c : cache) {
-                    if (c.first == cur_ter) {
-                        info = c.second;
-                        break;
-                    }
-                }
-                // Nope, look in the hash map next
-                if (!info) {
-                    auto const it = otermap.find( cur_ter );
-                    if( it == otermap.end() ) {
-                        debugmsg( "Bad ter %s (%d, %d)", cur_ter.c_str(), omx, omy );
-                        ter_color = c_red;
-                        ter_sym   = '?';
-                    } else {
-                        // cache the new value
-                        info = &it->second;
-                        cache[cache_next] = std::make_pair( cur_ter, info );
-                        cache_next = ( cache_next + 1 ) % cache_size;
-                    }
-                }
-                // Ok, we found something
-                if (info) {
-                    // Map tile marked as explored
-                    bool const explored = show_explored && overmap_buffer.is_explored(omx, omy, z);
-                    ter_color = explored ? c_dkgray : info->color;
-                    ter_sym   = info->sym;
-                }
+                // Map tile marked as explored
+                ter_color = show_explored && glyph.explored ? c_dkgray : glyph.color;
+                ter_sym   = glyph.sym;
             }
 
             // Are we debugging monster groups?
@@ -1861,7 +1909,7 @@ void overmap::draw(WINDOW *w, WINDOW *wbar, const tripoint &center,
                     }
                     // Set the color only if we encountered an eligible group.
                     if( ter_sym == '+' || ter_sym == '-' ) {
-                        if( los ) {
+                        if( los() ) {
                             ter_color = c_ltblue;
                         } else {
                             ter_color = c_blue;
@@ -2153,6 +2201,9 @@ tripoint overmap::draw_overmap(const tripoint &orig, const draw_data_t &data)
         curs = tripoint(data.select);
     }
 
+    // The game may have changed the overmap since it has been shown last time.
+    clear_om_glyph_cache();
+
     // Configure input context for navigating the map.
     input_context ictxt("OVERMAP");
     ictxt.register_action("ANY_INPUT");
@@ -2213,10 +2264,12 @@ tripoint overmap::draw_overmap(const tripoint &orig, const draw_data_t &data)
                 // do nothing, the player should be using [D]elete
             } else if( old_note != new_note ) {
                 overmap_buffer.add_note( curs, new_note );
+                clear_om_glyph_cache();
             }
         } else if( action == "DELETE_NOTE" ) {
             if( overmap_buffer.has_note( curs ) && query_yn( _( "Really delete note?" ) ) ) {
                 overmap_buffer.delete_note( curs );
+                clear_om_glyph_cache();
             }
         } else if (action == "LIST_NOTES") {
             const point p = display_notes(curs.z);
@@ -2244,6 +2297,7 @@ tripoint overmap::draw_overmap(const tripoint &orig, const draw_data_t &data)
             }
         } else if (action == "TOGGLE_EXPLORED") {
             overmap_buffer.toggle_explored(curs.x, curs.y, curs.z);
+            clear_om_glyph_cache();
         } else if (action == "SEARCH") {
             std::string term = string_input_popup(_("Search term:"));
             if(term.empty()) {
@@ -2410,6 +2464,7 @@ tripoint overmap::draw_overmap(const tripoint &orig, const draw_data_t &data)
                                 overmap_buffer.set_seen( pos.x, pos.y, pos.z, true );
                             }
                         }
+                        clear_om_glyph_cache();
                         break;
                     } else if( action == "ROTATE" &&
                                ( ( terrain && uistate.place_terrain->has_flag( rotates ) ) ||
@@ -2441,6 +2496,7 @@ tripoint overmap::draw_overmap(const tripoint &orig, const draw_data_t &data)
             }
         }
     } while (action != "QUIT" && action != "CONFIRM");
+    clear_om_glyph_cache();
     werase(g->w_overmap);
     werase(g->w_omlegend);
     erase();
@@ -2466,13 +2522,13 @@ tripoint overmap::find_random_omt( const std::string &omt_base_type ) const
 void overmap::process_mongroups()
 {
     for( auto it = zg.begin(); it != zg.end(); ) {
-        mongroup &mg = it->second;
+        mongroup &mg = *it;
         if( mg.dying ) {
             mg.population = (mg.population * 4) / 5;
             mg.radius = (mg.radius * 9) / 10;
         }
         if( mg.empty() ) {
-            zg.erase( it++ );
+            it = zg.erase( it );
         } else {
             ++it;
         }
@@ -2517,13 +2573,11 @@ void mongroup::wander( overmap &om )
 
 void overmap::move_hordes()
 {
-    // Prevent hordes to be moved twice by putting them in here after moving.
-    decltype(zg) tmpzg;
     //MOVE ZOMBIE GROUPS
-    for( auto it = zg.begin(); it != zg.end(); ) {
-        mongroup &mg = it->second;
+    // Groups are moved in place, so each of them is visited exactly once.
+    for( auto it = zg.begin(); it != zg.end(); ++it ) {
+        mongroup &mg = *it;
         if( !mg.horde ) {
-            ++it;
             continue;
         }
 
@@ -2552,28 +2606,22 @@ void overmap::move_hordes()
         if( one_in(movement_chance) && rng(0, 100) < mg.interest ) {
             // TODO: Adjust for monster speed.
             // TODO: Handle moving to adjacent overmaps.
-            if( mg.pos.x > mg.target.x) {
-                mg.pos.x--;
+            tripoint new_pos = mg.pos;
+            if( new_pos.x > mg.target.x) {
+                new_pos.x--;
             }
-            if( mg.pos.x < mg.target.x) {
-                mg.pos.x++;
+            if( new_pos.x < mg.target.x) {
+                new_pos.x++;
             }
-            if( mg.pos.y > mg.target.y) {
-                mg.pos.y--;
+            if( new_pos.y > mg.target.y) {
+                new_pos.y--;
             }
-            if( mg.pos.y < mg.target.y) {
-                mg.pos.y++;
+            if( new_pos.y < mg.target.y) {
+                new_pos.y++;
             }
-
-            // Erase the group at it's old location, add the group with the new location
-            tmpzg.insert( std::pair<tripoint, mongroup>( mg.pos, mg ) );
-            zg.erase( it++ );
-        } else {
-            ++it;
+            zg.move( it, new_pos );
         }
     }
-    // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
 
 
     if(ACTIVE_WORLD_OPTIONS["WANDER_SPAWNS"]) {
@@ -2606,16 +2654,12 @@ void overmap::move_hordes()
 
             // Scan for compatible hordes in this area.
             mongroup *add_to_group = NULL;
-            auto group_bucket = zg.equal_range(p);
-            std::for_each( group_bucket.first, group_bucket.second,
-                [&](std::pair<const tripoint, mongroup> &horde_entry ) {
-                mongroup &horde = horde_entry.second;
-
+            for( mongroup *horde : zg.at( p ) ) {
                 // We only absorb zombies into GROUP_ZOMBIE hordes
-                if(horde.horde && !horde.monsters.empty() && horde.type == GROUP_ZOMBIE) {
-                    add_to_group = &horde;
+                if(horde->horde && !horde->monsters.empty() && horde->type == GROUP_ZOMBIE) {
+                    add_to_group = horde;
                 }
-            });
+            }
 
             // If there is no horde to add the monster to, create one.
             if(add_to_group == NULL) {
@@ -2639,15 +2683,12 @@ void overmap::move_hordes()
 */
 void overmap::signal_hordes( const tripoint &p, const int sig_power)
 {
-    for( auto &elem : zg ) {
-        mongroup &mg = elem.second;
+    // Hordes at sig_power or further away don't react at all.
+    zg.for_each_in_radius( p, sig_power - 1, [&p, sig_power]( mongroup & mg ) {
         if( !mg.horde ) {
-            continue;
+            return;
         }
             const int dist = rl_dist( p, mg.pos );
-            if( sig_power <= dist ) {
-                continue;
-            }
             // TODO: base this in monster attributes, foremost GOODHEARING.
             const int d_inter = (sig_power - dist) * 5;
             const int roll = rng( 0, mg.interest );
@@ -2663,7 +2704,7 @@ void overmap::signal_hordes( const tripoint &p, const int sig_power)
                     mg.set_interest( d_inter );
                 }
             }
-    }
+    } );
 }
 
 void grow_forest_oter_id(oter_id &oid, bool swampy)
@@ -3967,7 +4008,7 @@ void overmap::place_specials()
             num_placed.emplace( &special, 0 );
         } else {
             // occurrence is actually a % chance, so less than 1
-            if( rand() % 100 <= special.min_occurrences ) {
+            if( rng( 0, 99 ) <= special.min_occurrences ) {
                 // Priority add one in this map
                 num_placed.emplace( &special, -1 );
             } else {
@@ -4562,7 +4603,7 @@ void overmap::add_mon_group(const mongroup &group)
     // makes the diffuse setting obsolete (as it only controls how the radius
     // is interpreted) - it's only used when adding monster groups with function.
     if( group.radius == 1 ) {
-        zg.insert(std::pair<tripoint, mongroup>( group.pos, group ) );
+        zg.insert( group );
         return;
     }
     // diffuse groups use a circular area, non-diffuse groups use a rectangular area
@@ -7,6 +7,7 @@
 #include "weighted_list.h"
 #include "game_constants.h"
 #include "monster.h"
+#include "mongroup.h"
 
 #include <array>
 #include <iosfwd>
@@ -174,7 +175,7 @@ struct radio_tower {
  int frequency;
 radio_tower(int X = -1, int Y = -1, int S = -1, std::string M = "",
             radio_type T = MESSAGE_BROADCAST) :
-    x (X), y (Y), strength (S), type (T), message (M) {frequency = rand();}
+    x (X), y (Y), strength (S), type (T), message (M) {frequency = rng( 0, RAND_MAX );}
 };
 
 struct map_layer {
@@ -314,7 +315,7 @@ class overmap
   }
     void clear_mon_groups();
 private:
-    std::multimap<tripoint, mongroup> zg;
+    mongroup_grid zg;
 public:
     /** Unit test enablers to check if a given mongroup is present. */
     bool mongroup_check(const mongroup &candidate) const;
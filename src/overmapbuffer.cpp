@@ -74,11 +74,11 @@ overmap &overmapbuffer::get( const int x, const int y )
 void overmapbuffer::fix_mongroups(overmap &new_overmap)
 {
     for( auto it = new_overmap.zg.begin(); it != new_overmap.zg.end(); ) {
-        auto &mg = it->second;
+        auto &mg = *it;
         // spawn related code simply sets population to 0 when they have been
         // transformed into spawn points on a submap, the group can then be removed
         if( mg.empty() ) {
-            new_overmap.zg.erase( it++ );
+            it = new_overmap.zg.erase( it );
             continue;
         }
         // Inside the bounds of the overmap?
@@ -96,10 +96,11 @@ void overmapbuffer::fix_mongroups(overmap &new_overmap)
             continue;
         }
         overmap &om = get( omp.x, omp.y );
-        mg.pos.x = smabs.x;
-        mg.pos.y = smabs.y;
-        om.add_mon_group( mg );
-        new_overmap.zg.erase( it++ );
+        mongroup moved = mg;
+        moved.pos.x = smabs.x;
+        moved.pos.y = smabs.y;
+        om.add_mon_group( moved );
+        it = new_overmap.zg.erase( it );
     }
 }
 
@@ -362,12 +363,11 @@ std::vector<mongroup*> overmapbuffer::groups_at(int x, int y, int z)
     }
     const tripoint dpos( x, y, z );
     overmap &om = get( omp.x, omp.y );
-    for( auto it = om.zg.lower_bound( dpos ), end = om.zg.upper_bound( dpos ); it != end; ++it ) {
-        auto &mg = it->second;
-        if( mg.empty() ) {
+    for( auto mg : om.zg.at( dpos ) ) {
+        if( mg->empty() ) {
             continue;
         }
-        result.push_back( &mg );
+        result.push_back( mg );
     }
     return result;
 }
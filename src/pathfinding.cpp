@@ -11,6 +11,7 @@
 #include "submap.h"
 #include "mapdata.h"
 #include "cata_utility.h"
+#include "calendar.h"
 #include "pathfinding.h"
 
 #include <algorithm>
@@ -32,44 +33,72 @@ constexpr int flat_index( const int x, const int y )
 };
 
 // Flattened 2D array representing a single z-level worth of pathfinding data
+// Layers are kept between searches. Instead of clearing the whole layer each time,
+// every entry is stamped with the search that last touched it and entries with an
+// older stamp are treated as unvisited.
 struct path_data_layer {
     // State is accessed way more often than all other values here
     std::array< astar_state, SEEX *MAPSIZE *SEEY *MAPSIZE > state;
+    std::array< unsigned int, SEEX *MAPSIZE *SEEY *MAPSIZE > generation;
     std::array< int, SEEX *MAPSIZE *SEEY *MAPSIZE > score;
     std::array< int, SEEX *MAPSIZE *SEEY *MAPSIZE > gscore;
     std::array< tripoint, SEEX *MAPSIZE *SEEY *MAPSIZE > parent;
 
-    void init( const int minx, const int miny, const int maxx, const int maxy ) {
-        for( int x = minx; x <= maxx; x++ ) {
-            for( int y = miny; y <= maxy; y++ ) {
-                const int ind = flat_index( x, y );
-                state[ind] = ASL_NONE; // Mark as unvisited
-            }
+    // Generation of the search currently using this layer
+    unsigned int current_generation = 0;
+
+    path_data_layer() {
+        generation.fill( 0 );
+    }
+
+    astar_state &state_at( const int index ) {
+        if( generation[index] != current_generation ) {
+            generation[index] = current_generation;
+            state[index] = ASL_NONE; // Mark as unvisited
         }
-    };
-};
 
-struct pathfinder {
-    int minx;
-    int miny;
-    int maxx;
-    int maxy;
-    pathfinder( int _minx, int _miny, int _maxx, int _maxy ) :
-        minx( _minx ), miny( _miny ), maxx( _maxx ), maxy( _maxy ) {
+        return state[index];
     }
+};
 
-    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp >
-    open;
+struct pathfinder {
+    int minx = 0;
+    int miny = 0;
+    int maxx = 0;
+    int maxy = 0;
+    unsigned int generation = 0;
+
+    // Binary heap of open points, kept in a vector so that its storage is reused
+    std::vector< std::pair<int, tripoint> > open;
     std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
 
+    /** Starts a new search, invalidating all data from the previous one. */
+    void reset( const int _minx, const int _miny, const int _maxx, const int _maxy ) {
+        minx = _minx;
+        miny = _miny;
+        maxx = _maxx;
+        maxy = _maxy;
+        open.clear();
+
+        generation++;
+        if( generation == 0 ) {
+            // Wrapped around, old stamps could now look current
+            for( auto &ptr : path_data ) {
+                if( ptr != nullptr ) {
+                    ptr->generation.fill( 0 );
+                }
+            }
+            generation = 1;
+        }
+    }
+
     path_data_layer &get_layer( const int z ) {
         auto &ptr = path_data[z + OVERMAP_DEPTH];
-        if( ptr != nullptr ) {
-            return *ptr;
+        if( ptr == nullptr ) {
+            ptr = std::unique_ptr<path_data_layer>( new path_data_layer() );
         }
 
-        ptr = std::unique_ptr<path_data_layer>( new path_data_layer() );
-        ptr->init( minx, miny, maxx, maxy );
+        ptr->current_generation = generation;
         return *ptr;
     }
 
@@ -78,39 +107,49 @@ struct pathfinder {
     }
 
     tripoint get_next() {
-        auto pt = open.top();
-        open.pop();
-        return pt.second;
+        std::pop_heap( open.begin(), open.end(), pair_greater_cmp() );
+        const tripoint pt = open.back().second;
+        open.pop_back();
+        return pt;
     }
 
     void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
         auto &layer = get_layer( to.z );
         const int index = flat_index( to.x, to.y );
-        if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
-            layer.state[index] == ASL_CLOSED ) {
+        auto &state = layer.state_at( index );
+        if( ( state == ASL_OPEN && gscore >= layer.gscore[index] ) ||
+            state == ASL_CLOSED ) {
             return;
         }
 
-        layer.state [index] = ASL_OPEN;
+        state = ASL_OPEN;
         layer.gscore[index] = gscore;
         layer.parent[index] = from;
         layer.score [index] = score;
-        open.push( std::make_pair( score, to ) );
+        open.emplace_back( score, to );
+        std::push_heap( open.begin(), open.end(), pair_greater_cmp() );
     }
 
     void close_point( const tripoint &p ) {
         auto &layer = get_layer( p.z );
         const int index = flat_index( p.x, p.y );
-        layer.state[index] = ASL_CLOSED;
+        layer.state_at( index ) = ASL_CLOSED;
     }
 
     void unclose_point( const tripoint &p ) {
         auto &layer = get_layer( p.z );
         const int index = flat_index( p.x, p.y );
-        layer.state[index] = ASL_NONE;
+        layer.state_at( index ) = ASL_NONE;
     }
 };
 
+// Shared between all calls to map::route, so that its buffers are only allocated once
+static pathfinder &get_pathfinder()
+{
+    static pathfinder pf;
+    return pf;
+}
+
 // Returns a tile with `flag` in the overmap tile that `t` is on
 template<ter_bitflags flag>
 tripoint vertical_move_destination( const map &m, const tripoint &t )
@@ -178,6 +217,31 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     return route( f, t, bash, maxdist, {{ g->u.pos() }} );
 }
 
+// Returns true and stores the line in `path` if there is a simple straight line
+// on flat ground from f to t, which doesn't contain any pre-closed tiles
+static bool straight_route( const map &m, const tripoint &f, const tripoint &t,
+                            const std::set<tripoint> &pre_closed, std::vector<tripoint> &path )
+{
+    if( f.z != t.z || !m.clear_path( f, t, -1, 2, 2 ) ) {
+        return false;
+    }
+
+    auto line_path = line_to( f, t );
+    const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
+    if( !is_disjoint( sorted_line, pre_closed ) ) {
+        return false;
+    }
+
+    path = std::move( line_path );
+    return true;
+}
+
+// Routes shorter than this are cheap enough to do with plain A*
+constexpr int hierarchical_route_min_dist = SEEX * 2;
+// Abstract routes of bashers that are this many times longer than the straight line
+// are left to plain A*, which may find it cheaper to bash through instead
+constexpr int bash_detour_factor = 2;
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const int bash, const int maxdist,
                                   const std::set<tripoint> &pre_closed ) const
@@ -185,10 +249,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     /* TODO: If the origin or destination is out of bound, figure out the closest
      * in-bounds point and go to that, then to the real origin/destination.
      */
-    std::vector<tripoint> ret;
-
     if( !inbounds( f ) ) {
-        return ret;
+        return std::vector<tripoint>();
     }
 
     if( !inbounds( t ) ) {
@@ -196,17 +258,29 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         clip_to_bounds( clipped );
         return route( f, clipped, bash, maxdist );
     }
-    // First, check for a simple straight line on flat ground
-    // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    if( f.z == t.z && clear_path( f, t, -1, 2, 2 ) ) {
-        const auto line_path = line_to( f, t );
-        const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
 
-        if( is_disjoint( sorted_line, pre_closed ) ) {
-            return line_path;
+    if( f.z == t.z && rl_dist( f, t ) > hierarchical_route_min_dist ) {
+        auto ret = route_hierarchical( f, t, bash, maxdist, pre_closed );
+        if( !ret.empty() ) {
+            return ret;
         }
     }
 
+    return route_flat( f, t, bash, maxdist, pre_closed );
+}
+
+std::vector<tripoint> map::route_flat( const tripoint &f, const tripoint &t,
+                                       const int bash, const int maxdist,
+                                       const std::set<tripoint> &pre_closed ) const
+{
+    std::vector<tripoint> ret;
+
+    // First, check for a simple straight line on flat ground
+    // Except when the line contains a pre-closed tile - we need to do regular pathing then
+    if( straight_route( *this, f, t, pre_closed, ret ) ) {
+        return ret;
+    }
+
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
     int minx = std::min( f.x, t.x ) - pad;
     int miny = std::min( f.y, t.y ) - pad;
@@ -217,7 +291,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     clip_to_bounds( minx, miny, minz );
     clip_to_bounds( maxx, maxy, maxz );
 
-    pathfinder pf( minx, miny, maxx, maxy );
+    pathfinder &pf = get_pathfinder();
+    pf.reset( minx, miny, maxx, maxy );
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
@@ -238,7 +313,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
         const int parent_index = flat_index( cur.x, cur.y );
         auto &layer = pf.get_layer( cur.z );
-        auto &cur_state = layer.state[parent_index];
+        auto &cur_state = layer.state_at( parent_index );
         if( cur_state == ASL_CLOSED ) {
             continue;
         }
@@ -272,7 +347,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
-            if( layer.state[index] == ASL_CLOSED ) {
+            if( layer.state_at( index ) == ASL_CLOSED ) {
                 continue;
             }
 
@@ -299,7 +374,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                    bash_rating_internal( bash, furniture, terrain, false, veh, part );
 
                 if( cost == 0 && rating <= 0 && !terrain.open && veh == nullptr ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calc costs
+                    layer.state_at( index ) = ASL_CLOSED; // Close it so that next time we won't try to calc costs
                     continue;
                 }
 
@@ -326,7 +401,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                         } else {
                             if( !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
                                 // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
+                                layer.state_at( index ) = ASL_CLOSED;
                             }
 
                             continue;
@@ -363,7 +438,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                 }
 
                                 // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
+                                layer.state_at( index ) = ASL_CLOSED;
                                 continue;
                             }
                         } else {
@@ -376,7 +451,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
-            if( layer.state[index] == ASL_NONE || newg < layer.gscore[index] ) {
+            if( layer.state_at( index ) == ASL_NONE || newg < layer.gscore[index] ) {
                 pf.add_point( newg, newg + 2 * rl_dist( p, t ), cur, p );
             }
         }
@@ -449,3 +524,400 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+// Rough cost of stepping onto a tile, following the costs used by map::route_flat
+// Negative for tiles that can't be walked on (or opened)
+static int cluster_step_cost( const pf_special special )
+{
+    int cost = 2;
+    if( special & PF_WALL ) {
+        if( !( special & PF_DOOR ) ) {
+            // Bashing depends on the router, see route_hierarchical
+            return -1;
+        }
+        // To open and then move onto the tile, car doors take longer
+        cost = ( special & PF_VEHICLE ) ? 10 : 4;
+    } else if( special & PF_SLOW ) {
+        cost += 2;
+    }
+    if( special & PF_TRAP ) {
+        cost += 500;
+    }
+
+    return cost;
+}
+
+// Fields don't go further than that, chasers that far away won't see their target anyway
+constexpr int distance_field_max_cost = 2 * 60;
+// Only a handful of targets are chased at any time (the player and some NPCs)
+constexpr size_t distance_fields_kept = 8;
+
+const distance_field &map::get_distance_field( const tripoint &target ) const
+{
+    const int turn = calendar::turn;
+    auto iter = std::find_if( distance_fields.begin(), distance_fields.end(),
+    [&target, turn]( const std::unique_ptr<distance_field> &fld ) {
+        return fld->target == target && fld->turn == turn;
+    } );
+    if( iter != distance_fields.end() ) {
+        // Keep the most recently used fields in the front
+        std::rotate( distance_fields.begin(), iter, iter + 1 );
+        return *distance_fields.front();
+    }
+
+    std::unique_ptr<distance_field> fld;
+    if( distance_fields.size() >= distance_fields_kept ) {
+        // Reuse the least recently used field
+        fld = std::move( distance_fields.back() );
+        distance_fields.pop_back();
+    } else {
+        fld = std::unique_ptr<distance_field>( new distance_field() );
+    }
+    fld->target = target;
+    fld->turn = turn;
+    std::fill_n( &fld->dist[0][0], MAPSIZE * SEEX * MAPSIZE * SEEY, -1 );
+
+    if( inbounds( target ) ) {
+        const auto &cache = get_pathfinding_cache_ref( target.z );
+        const int maxx = my_MAPSIZE * SEEX;
+        const int maxy = my_MAPSIZE * SEEY;
+        std::priority_queue< std::pair<int, point>, std::vector< std::pair<int, point> >,
+            std::greater< std::pair<int, point> > > open;
+        fld->dist[target.x][target.y] = 0;
+        open.emplace( 0, point( target.x, target.y ) );
+        while( !open.empty() ) {
+            const auto cur = open.top();
+            open.pop();
+            if( cur.first > fld->dist[cur.second.x][cur.second.y] ) {
+                continue;
+            }
+
+            // Chasers pay for stepping onto `cur` on their way to the target
+            // The target tile itself may be something solid, like a vehicle part
+            const int step = cur.first == 0 ? 2 :
+                             cluster_step_cost( cache.special[cur.second.x][cur.second.y] );
+            for( int dx = -1; dx <= 1; dx++ ) {
+                for( int dy = -1; dy <= 1; dy++ ) {
+                    const int x = cur.second.x + dx;
+                    const int y = cur.second.y + dy;
+                    if( ( dx == 0 && dy == 0 ) || x < 0 || y < 0 || x >= maxx || y >= maxy ||
+                        ( cache.special[x][y] & PF_WALL ) ) {
+                        continue;
+                    }
+
+                    const int newg = cur.first + step + ( ( dx != 0 && dy != 0 ) ? 1 : 0 );
+                    int &old = fld->dist[x][y];
+                    if( newg <= distance_field_max_cost && ( old < 0 || newg < old ) ) {
+                        old = newg;
+                        open.emplace( newg, point( x, y ) );
+                    }
+                }
+            }
+        }
+    }
+
+    distance_fields.insert( distance_fields.begin(), std::move( fld ) );
+    return *distance_fields.front();
+}
+
+// Dijkstra from `from` to every tile of the submap that starts at x0, y0
+// Paths don't leave the submap. Unreachable tiles get a negative distance.
+static void cluster_distances( const pathfinding_cache &cache, const int x0, const int y0,
+                               const point &from, std::array<int, SEEX * SEEY> &dist )
+{
+    const auto local_index = [x0, y0]( const int x, const int y ) {
+        return ( x - x0 ) * SEEY + ( y - y0 );
+    };
+
+    dist.fill( -1 );
+    std::priority_queue< std::pair<int, point>, std::vector< std::pair<int, point> >,
+        std::greater< std::pair<int, point> > > open;
+    dist[local_index( from.x, from.y )] = 0;
+    open.emplace( 0, from );
+    while( !open.empty() ) {
+        const auto cur = open.top();
+        open.pop();
+        if( cur.first > dist[local_index( cur.second.x, cur.second.y )] ) {
+            continue;
+        }
+
+        for( int dx = -1; dx <= 1; dx++ ) {
+            for( int dy = -1; dy <= 1; dy++ ) {
+                const int x = cur.second.x + dx;
+                const int y = cur.second.y + dy;
+                if( ( dx == 0 && dy == 0 ) ||
+                    x < x0 || x >= x0 + SEEX || y < y0 || y >= y0 + SEEY ) {
+                    continue;
+                }
+
+                const int step = cluster_step_cost( cache.special[x][y] );
+                if( step < 0 ) {
+                    continue;
+                }
+
+                // Penalize for diagonals like route_flat does
+                const int newg = cur.first + step + ( ( dx != 0 && dy != 0 ) ? 1 : 0 );
+                int &old = dist[local_index( x, y )];
+                if( old < 0 || newg < old ) {
+                    old = newg;
+                    open.emplace( newg, point( x, y ) );
+                }
+            }
+        }
+    }
+}
+
+void map::update_pathfinding_clusters( const int zlev ) const
+{
+    auto &cache = get_pathfinding_cache( zlev );
+    if( cache.clusters_dirty.none() ) {
+        return;
+    }
+
+    const auto passable = [&cache]( const int x, const int y ) {
+        return cluster_step_cost( cache.special[x][y] ) >= 0;
+    };
+
+    std::array<int, SEEX * SEEY> dist;
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !cache.clusters_dirty[smx * MAPSIZE + smy] ) {
+                continue;
+            }
+
+            auto &cluster = cache.clusters[smx * MAPSIZE + smy];
+            auto &entrances = cluster.entrances;
+            entrances.clear();
+
+            const int x0 = smx * SEEX;
+            const int y0 = smy * SEEY;
+            // Walks the edge starting at (ex, ey) in steps of (ax, ay). (nx, ny) is the offset
+            // to the matching tile in the neighboring submap. The neighbor scans the same pairs
+            // of tiles, so both sides end up with adjacent entrances.
+            const auto scan_edge = [&]( const int ex, const int ey, const int ax, const int ay,
+                                        const int nx, const int ny ) {
+                const int len = ax != 0 ? SEEX : SEEY;
+                int run_start = -1;
+                for( int i = 0; i <= len; i++ ) {
+                    const int x = ex + i * ax;
+                    const int y = ey + i * ay;
+                    const bool open = i < len && passable( x, y ) && passable( x + nx, y + ny );
+                    if( open && run_start < 0 ) {
+                        run_start = i;
+                    } else if( !open && run_start >= 0 ) {
+                        const int mid = ( run_start + i - 1 ) / 2;
+                        const point entrance( ex + mid * ax, ey + mid * ay );
+                        if( std::find( entrances.begin(), entrances.end(), entrance ) == entrances.end() ) {
+                            entrances.push_back( entrance );
+                        }
+                        run_start = -1;
+                    }
+                }
+            };
+
+            if( smx > 0 ) {
+                scan_edge( x0, y0, 0, 1, -1, 0 );
+            }
+            if( smx + 1 < my_MAPSIZE ) {
+                scan_edge( x0 + SEEX - 1, y0, 0, 1, 1, 0 );
+            }
+            if( smy > 0 ) {
+                scan_edge( x0, y0, 1, 0, 0, -1 );
+            }
+            if( smy + 1 < my_MAPSIZE ) {
+                scan_edge( x0, y0 + SEEY - 1, 1, 0, 0, 1 );
+            }
+
+            const size_t num = entrances.size();
+            cluster.costs.assign( num * num, -1 );
+            for( size_t i = 0; i < num; i++ ) {
+                cluster_distances( cache, x0, y0, entrances[i], dist );
+                for( size_t j = 0; j < num; j++ ) {
+                    cluster.costs[i * num + j] = dist[( entrances[j].x - x0 ) * SEEY + entrances[j].y - y0];
+                }
+            }
+        }
+    }
+
+    cache.clusters_dirty.reset();
+}
+
+std::vector<tripoint> map::route_hierarchical( const tripoint &f, const tripoint &t,
+                                               const int bash, const int maxdist,
+                                               const std::set<tripoint> &pre_closed ) const
+{
+    std::vector<tripoint> ret;
+    if( straight_route( *this, f, t, pre_closed, ret ) ) {
+        return ret;
+    }
+
+    const int fsm = ( f.x / SEEX ) * MAPSIZE + f.y / SEEY;
+    const int tsm = ( t.x / SEEX ) * MAPSIZE + t.y / SEEY;
+    if( fsm == tsm ) {
+        return ret;
+    }
+
+    // Also brings the special tile cache up to date
+    get_pathfinding_cache_ref( f.z );
+    update_pathfinding_clusters( f.z );
+    const auto &cache = get_pathfinding_cache( f.z );
+
+    // Entrances of all submaps are numbered consecutively, start and goal come after them
+    std::array<int, MAPSIZE * MAPSIZE + 1> offsets;
+    offsets[0] = 0;
+    for( size_t i = 0; i < MAPSIZE * MAPSIZE; i++ ) {
+        offsets[i + 1] = offsets[i] + cache.clusters[i].entrances.size();
+    }
+    const int start_node = offsets.back();
+    const int goal_node = start_node + 1;
+
+    const auto &start_cluster = cache.clusters[fsm];
+    const auto &goal_cluster = cache.clusters[tsm];
+    if( start_cluster.entrances.empty() || goal_cluster.entrances.empty() ) {
+        return ret;
+    }
+
+    std::array<int, SEEX * SEEY> dist;
+    std::vector<int> start_costs( start_cluster.entrances.size() );
+    cluster_distances( cache, ( fsm / MAPSIZE ) * SEEX, ( fsm % MAPSIZE ) * SEEY, point( f.x, f.y ), dist );
+    for( size_t i = 0; i < start_costs.size(); i++ ) {
+        const point &e = start_cluster.entrances[i];
+        start_costs[i] = dist[( e.x % SEEX ) * SEEY + e.y % SEEY];
+    }
+    std::vector<int> goal_costs( goal_cluster.entrances.size() );
+    cluster_distances( cache, ( tsm / MAPSIZE ) * SEEX, ( tsm % MAPSIZE ) * SEEY, point( t.x, t.y ), dist );
+    for( size_t i = 0; i < goal_costs.size(); i++ ) {
+        const point &e = goal_cluster.entrances[i];
+        goal_costs[i] = dist[( e.x % SEEX ) * SEEY + e.y % SEEY];
+    }
+
+    // Kept between calls to avoid reallocating them for every route
+    static std::vector<int> gscore;
+    static std::vector<int> parent;
+    static std::vector<bool> closed;
+    static std::vector< std::pair<int, int> > open;
+    gscore.assign( goal_node + 1, -1 );
+    parent.assign( goal_node + 1, -1 );
+    closed.assign( goal_node + 1, false );
+    open.clear();
+
+    const auto node_cluster = [&offsets]( const int node ) {
+        return static_cast<int>( std::upper_bound( offsets.begin(), offsets.end(), node ) -
+                                 offsets.begin() ) - 1;
+    };
+    const auto node_pos = [&]( const int node ) {
+        if( node == start_node ) {
+            return point( f.x, f.y );
+        } else if( node == goal_node ) {
+            return point( t.x, t.y );
+        }
+        const int c = node_cluster( node );
+        return cache.clusters[c].entrances[node - offsets[c]];
+    };
+    const auto add_node = [&]( const int node, const int from, const int g ) {
+        if( closed[node] || ( gscore[node] >= 0 && gscore[node] <= g ) ) {
+            return;
+        }
+        gscore[node] = g;
+        parent[node] = from;
+        const point p = node_pos( node );
+        open.emplace_back( g + 2 * rl_dist( p.x, p.y, t.x, t.y ), node );
+        std::push_heap( open.begin(), open.end(), std::greater< std::pair<int, int> >() );
+    };
+
+    gscore[start_node] = 0;
+    for( size_t i = 0; i < start_costs.size(); i++ ) {
+        if( start_costs[i] >= 0 ) {
+            add_node( offsets[fsm] + i, start_node, start_costs[i] );
+        }
+    }
+
+    constexpr std::array<int, 4> x_offset{{ -1, 1, 0, 0 }};
+    constexpr std::array<int, 4> y_offset{{ 0, 0, -1, 1 }};
+    while( !open.empty() ) {
+        std::pop_heap( open.begin(), open.end(), std::greater< std::pair<int, int> >() );
+        const int cur = open.back().second;
+        open.pop_back();
+        if( closed[cur] ) {
+            continue;
+        }
+        closed[cur] = true;
+        if( cur == goal_node ) {
+            break;
+        }
+
+        const int c = node_cluster( cur );
+        const auto &cluster = cache.clusters[c];
+        const size_t idx = cur - offsets[c];
+        const int g = gscore[cur];
+
+        // Walk through the submap to its other entrances
+        for( size_t j = 0; j < cluster.entrances.size(); j++ ) {
+            const int cost = cluster.cost( idx, j );
+            if( j != idx && cost >= 0 ) {
+                add_node( offsets[c] + j, cur, g + cost );
+            }
+        }
+
+        if( c == tsm && goal_costs[idx] >= 0 ) {
+            add_node( goal_node, cur, g + goal_costs[idx] );
+        }
+
+        // Step over the edge into the neighboring submap
+        const point &pos = cluster.entrances[idx];
+        for( size_t i = 0; i < 4; i++ ) {
+            const int nx = pos.x + x_offset[i];
+            const int ny = pos.y + y_offset[i];
+            if( !inbounds( nx, ny ) ) {
+                continue;
+            }
+            const int nc = ( nx / SEEX ) * MAPSIZE + ny / SEEY;
+            if( nc == c ) {
+                continue;
+            }
+            const auto &neighbor = cache.clusters[nc].entrances;
+            const auto iter = std::find( neighbor.begin(), neighbor.end(), point( nx, ny ) );
+            if( iter != neighbor.end() ) {
+                add_node( offsets[nc] + ( iter - neighbor.begin() ), cur,
+                          g + cluster_step_cost( cache.special[nx][ny] ) );
+            }
+        }
+    }
+
+    if( !closed[goal_node] || gscore[goal_node] > maxdist ) {
+        return ret;
+    }
+    // Walls that could be bashed are not part of the abstract graph. If they force a long
+    // detour, let route_flat (via map::route) weigh the detour against bashing through.
+    if( bash > 0 && gscore[goal_node] > bash_detour_factor * 2 * rl_dist( f, t ) ) {
+        return ret;
+    }
+
+    std::vector<tripoint> waypoints;
+    for( int node = goal_node; node != -1; node = parent[node] ) {
+        const point p = node_pos( node );
+        waypoints.emplace_back( p.x, p.y, f.z );
+    }
+    std::reverse( waypoints.begin(), waypoints.end() );
+
+    // Let route_flat handle paths that have to squeeze past the pre-closed tiles
+    for( const auto &p : waypoints ) {
+        if( p != f && p != t && pre_closed.count( p ) > 0 ) {
+            return ret;
+        }
+    }
+
+    // Refine the route into tiles one leg at a time
+    for( size_t i = 1; i < waypoints.size(); i++ ) {
+        if( waypoints[i - 1] == waypoints[i] ) {
+            continue;
+        }
+        const auto leg = route_flat( waypoints[i - 1], waypoints[i], bash, maxdist, pre_closed );
+        if( leg.empty() ) {
+            return std::vector<tripoint>();
+        }
+        ret.insert( ret.end(), leg.begin(), leg.end() );
+    }
+
+    return ret;
+}
@@ -1,6 +1,13 @@
 #ifndef PATHFINDING_H
 #define PATHFINDING_H
 
+#include "game_constants.h"
+#include "enums.h"
+
+#include <array>
+#include <bitset>
+#include <vector>
+
 enum pf_special : char {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
     PF_SLOW = 0x01,      // Tile with move cost >2
@@ -9,6 +16,7 @@ enum pf_special : char {
     PF_FIELD = 0x08,     // Dangerous field
     PF_TRAP = 0x10,      // Dangerous trap
     PF_UPDOWN = 0x20,    // Stairs, ramp etc.
+    PF_DOOR = 0x40,      // Closed door that can be opened from both sides (also PF_WALL)
 };
 
 constexpr pf_special operator | ( pf_special lhs, pf_special rhs )
@@ -33,13 +41,59 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
+/**
+ * Abstract view of a single submap used by the hierarchical pathfinder.
+ * Entrances are the tiles on the submap edges through which it can be entered
+ * from a neighboring submap, one per contiguous passable stretch of the border.
+ */
+struct pathfinding_cluster {
+    /** Entrance tiles, in map coordinates of the owning z-level. */
+    std::vector<point> entrances;
+    /**
+     * Cost of walking from entrance i to entrance j without leaving the submap,
+     * stored at `i * entrances.size() + j`. Negative if there is no such path.
+     */
+    std::vector<int> costs;
+
+    int cost( const size_t from, const size_t to ) const {
+        return costs[from * entrances.size() + to];
+    }
+};
+
 struct pathfinding_cache {
     pathfinding_cache();
     ~pathfinding_cache();
 
-    bool dirty;
+    // One bit per submap, indexed by `gridx * MAPSIZE + gridy`
+    std::bitset<MAPSIZE * MAPSIZE> dirty;
+    // Submaps whose entry in clusters needs to be rebuilt, indexed as above
+    std::bitset<MAPSIZE * MAPSIZE> clusters_dirty;
 
     pf_special special[MAPSIZE * SEEX][MAPSIZE * SEEY];
+
+    std::array<pathfinding_cluster, MAPSIZE * MAPSIZE> clusters;
+};
+
+/**
+ * Walking cost from every tile of a z-level to a single target, computed once
+ * and shared by everything that wants to get to that target during a turn.
+ * See map::get_distance_field.
+ */
+struct distance_field {
+    tripoint target;
+    /** Turn on which the field was calculated. */
+    int turn;
+    /** Cost to reach the target, negative if it couldn't be reached within the limit. */
+    int dist[MAPSIZE * SEEX][MAPSIZE * SEEY];
+
+    /** Cost from p to the target or a negative value if it is not known. */
+    int at( const tripoint &p ) const {
+        if( p.z != target.z || p.x < 0 || p.y < 0 ||
+            p.x >= MAPSIZE * SEEX || p.y >= MAPSIZE * SEEY ) {
+            return -1;
+        }
+        return dist[p.x][p.y];
+    }
 };
 
 #endif
@@ -29,6 +29,8 @@
 #include "sounds.h"
 #include "item_action.h"
 #include "mongroup.h"
+#include "monster.h"
+#include "creature_tracker.h"
 #include "morale.h"
 #include "morale_types.h"
 #include "input.h"
@@ -13244,10 +13246,33 @@ bool player::is_visible_in_range( const Creature &critter, const int range ) con
 
 std::vector<Creature *> player::get_visible_creatures( const int range ) const
 {
-    return get_creatures_if( [this, range]( const Creature &critter ) -> bool {
-        return this != &critter && this->sees(critter) &&
-          rl_dist( this->pos(), critter.pos() ) <= range;
+    // Only look at the monsters that are in range instead of testing all of them.
+    std::vector<std::pair<int, Creature *>> monsters;
+    g->critter_tracker->for_each_in_radius( pos(), range, [this, &monsters]( monster & critter ) {
+        if( sees( critter ) ) {
+            monsters.emplace_back( g->mon_at( critter.pos(), true ), &critter );
+        }
     } );
+    // Keep the order of the monster list, the index doesn't guarantee any order.
+    std::sort( monsters.begin(), monsters.end() );
+    std::vector<Creature *> result;
+    result.reserve( monsters.size() );
+    for( const auto &elem : monsters ) {
+        result.push_back( elem.second );
+    }
+    const auto pred = [this, range]( const Creature &critter ) {
+        return this != &critter && this->sees( critter ) &&
+               rl_dist( this->pos(), critter.pos() ) <= range;
+    };
+    for( auto &n : g->active_npc ) {
+        if( pred( *n ) ) {
+            result.push_back( n );
+        }
+    }
+    if( pred( g->u ) ) {
+        result.push_back( &g->u );
+    }
+    return result;
 }
 
 std::vector<Creature *> player::get_targetable_creatures( const int range ) const
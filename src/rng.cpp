@@ -1,26 +1,124 @@
 #include "output.h"
 #include "rng.h"
-#include <stdlib.h>
 
-long rng( long val1, long val2 )
+namespace
+{
+
+/** Used to expand a seed into the full state, as recommended for xoshiro. */
+uint64_t splitmix64( uint64_t &x )
+{
+    uint64_t z = ( x += 0x9e3779b97f4a7c15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+}
+
+inline uint64_t rotl( const uint64_t x, const int k )
+{
+    return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+rng_context &thread_default_context()
+{
+    static thread_local rng_context ctx;
+    return ctx;
+}
+
+/** Installed by rng_context::scope, nullptr means the thread's default engine. */
+thread_local rng_context *installed_context = nullptr;
+
+} // namespace
+
+rng_context::rng_context( const uint64_t seed )
+{
+    this->seed( seed );
+}
+
+void rng_context::seed( uint64_t seed )
+{
+    for( auto &elem : state ) {
+        elem = splitmix64( seed );
+    }
+}
+
+rng_context::result_type rng_context::operator()()
+{
+    const uint64_t result = rotl( state[1] * 5, 7 ) * 9;
+    const uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl( state[3], 45 );
+    return result;
+}
+
+double rng_context::next_double()
+{
+    // The upper 53 bits fill the mantissa of a double exactly.
+    return ( ( *this )() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+long rng_context::rng( long val1, long val2 )
 {
     long minVal = ( val1 < val2 ) ? val1 : val2;
     long maxVal = ( val1 < val2 ) ? val2 : val1;
-    return minVal + long( ( maxVal - minVal + 1 ) * double( rand() / double( RAND_MAX + 1.0 ) ) );
+    return minVal + long( ( maxVal - minVal + 1 ) * next_double() );
 }
 
-double rng_float( double val1, double val2 )
+double rng_context::rng_float( double val1, double val2 )
 {
     double minVal = ( val1 < val2 ) ? val1 : val2;
     double maxVal = ( val1 < val2 ) ? val2 : val1;
-    return minVal + ( maxVal - minVal ) * double( rand() ) / double( RAND_MAX + 1.0 );
+    return minVal + ( maxVal - minVal ) * next_double();
 }
 
-bool one_in( int chance )
+bool rng_context::one_in( int chance )
 {
     return ( chance <= 1 || rng( 0, chance - 1 ) == 0 );
 }
 
+bool rng_context::x_in_y( double x, double y )
+{
+    return next_double() < x / y;
+}
+
+rng_context &rng_context::current()
+{
+    return installed_context != nullptr ? *installed_context : thread_default_context();
+}
+
+rng_context::scope::scope( rng_context &ctx ) : previous( installed_context )
+{
+    installed_context = &ctx;
+}
+
+rng_context::scope::~scope()
+{
+    installed_context = previous;
+}
+
+void rng_set_engine_seed( const uint64_t seed )
+{
+    rng_context::current().seed( seed );
+}
+
+long rng( long val1, long val2 )
+{
+    return rng_context::current().rng( val1, val2 );
+}
+
+double rng_float( double val1, double val2 )
+{
+    return rng_context::current().rng_float( val1, val2 );
+}
+
+bool one_in( int chance )
+{
+    return rng_context::current().one_in( chance );
+}
+
 //this works just like one_in, but it accepts doubles as input to calculate chances like "1 in 350,52"
 bool one_in_improved( double chance )
 {
@@ -29,7 +127,7 @@ bool one_in_improved( double chance )
 
 bool x_in_y( double x, double y )
 {
-    return ( ( double )rand() / RAND_MAX ) <= ( ( double )x / y );
+    return rng_context::current().x_in_y( x, y );
 }
 
 int dice( int number, int sides )
@@ -3,8 +3,70 @@
 
 #include "compatibility.h"
 
+#include <cstdint>
 #include <functional>
 
+/**
+ * A random number engine (xoshiro256**) with its own state.
+ *
+ * The free functions below (@ref rng, @ref one_in, ...) use the engine that is current
+ * in the calling thread. Each thread has its own default engine; code that needs a
+ * separate, reproducible stream (e.g. work done on another thread) can install its own
+ * engine with a @ref scope.
+ *
+ * Fulfills the requirements of a UniformRandomBitGenerator, so it can be used with
+ * the distributions and algorithms of the standard library as well.
+ */
+class rng_context
+{
+    public:
+        typedef uint64_t result_type;
+
+        explicit rng_context( uint64_t seed = 0 );
+        /** Resets the state, the same seed always yields the same sequence. */
+        void seed( uint64_t seed );
+        result_type operator()();
+        static constexpr result_type min() {
+            return 0;
+        }
+        static constexpr result_type max() {
+            return UINT64_MAX;
+        }
+
+        /** Uniformly distributed in [0, 1). */
+        double next_double();
+
+        long rng( long val1, long val2 );
+        double rng_float( double val1, double val2 );
+        bool one_in( int chance );
+        bool x_in_y( double x, double y );
+
+        /** The engine the free functions use in the calling thread. */
+        static rng_context &current();
+
+        /**
+         * Makes an engine the current one of the calling thread for the lifetime of
+         * this object. Scopes can be nested, the previous engine is restored afterwards.
+         */
+        class scope
+        {
+            public:
+                explicit scope( rng_context &ctx );
+                ~scope();
+                scope( const scope & ) = delete;
+                scope &operator=( const scope & ) = delete;
+
+            private:
+                rng_context *previous;
+        };
+
+    private:
+        uint64_t state[4];
+};
+
+/** Seeds the current engine of the calling thread, see @ref rng_context::current. */
+void rng_set_engine_seed( uint64_t seed );
+
 long rng( long val1, long val2 );
 double rng_float( double val1, double val2 );
 bool one_in( int chance );
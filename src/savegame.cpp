@@ -826,7 +826,7 @@ void overmap::serialize( std::ofstream &fout ) const
     json.member("mongroups");
     json.start_array();
     for( const auto &group : zg ) {
-        json.write(group.second);
+        json.write(group);
     }
     json.end_array();
     fout << std::endl;
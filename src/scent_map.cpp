@@ -0,0 +1,86 @@
+#include "scent_map.h"
+#include "debug.h"
+
+#include <algorithm>
+
+#define dbg(x) DebugLog((DebugLevel)(x),D_GAME) << __FILE__ << ":" << __LINE__ << ": "
+
+void scent_diffusion::clear_blockers( const int minx, const int miny, const int maxx, const int maxy )
+{
+    for( int x = minx; x <= maxx; ++x ) {
+        std::fill( &blocks_scent[x][miny], &blocks_scent[x][maxy] + 1, false );
+        std::fill( &reduces_scent[x][miny], &reduces_scent[x][maxy] + 1, false );
+    }
+}
+
+void scent_diffusion::diffuse( int ( &grscent )[SEEX * MAPSIZE][SEEY * MAPSIZE],
+                               const int minx, const int miny, const int maxx, const int maxy )
+{
+    const int diffusivity = 100; // decrease this to reduce gas spread. Keep it under 125 for
+    // stability. This is essentially a decimal number * 1000.
+
+    // Turn the flags into multipliers, so that the passes below don't need to branch on them
+    for( int x = minx - 1; x <= maxx + 1; ++x ) {
+        for( int y = miny - 1; y <= maxy + 1; ++y ) {
+            // only 20% of scent can diffuse on REDUCE_SCENT squares
+            weight[x][y] = !blocks_scent[x][y] * ( 10 - 8 * reduces_scent[x][y] );
+        }
+    }
+
+    // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
+    // times. Note: this needs an array that is one square larger on each side in the x direction
+    // than the final scent matrix.
+    for( int x = minx - 1; x <= maxx + 1; ++x ) {
+        const int *const w = weight[x];
+        const int *const s = grscent[x];
+        int *const sum = sum_3_scent_y[x];
+        int *const used = squares_used_y[x];
+        for( int y = miny; y <= maxy; ++y ) {
+            sum[y] = w[y - 1] * s[y - 1] + w[y] * s[y] + w[y + 1] * s[y + 1];
+            used[y] = w[y - 1] + w[y] + w[y + 1];
+        }
+    }
+
+    // Rest of the scent map
+    for( int x = minx; x <= maxx; ++x ) {
+        const bool *const blocks = blocks_scent[x];
+        const bool *const reduces = reduces_scent[x];
+        const int *const used_l = squares_used_y[x - 1];
+        const int *const used_c = squares_used_y[x];
+        const int *const used_r = squares_used_y[x + 1];
+        const int *const sum_l = sum_3_scent_y[x - 1];
+        const int *const sum_c = sum_3_scent_y[x];
+        const int *const sum_r = sum_3_scent_y[x + 1];
+        int *const s = grscent[x];
+        for( int y = miny; y <= maxy; ++y ) {
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = used_l[y] + used_c[y] + used_r[y];
+            // less air movement for REDUCE_SCENT square
+            const int this_diffusivity = diffusivity - reduces[y] * ( diffusivity - diffusivity / 5 );
+            // take the old scent and subtract what diffuses out
+            int temp_scent = s[y] * ( 10 * 1000 - squares_used * this_diffusivity );
+            // neighboring walls and reduce_scent squares absorb some scent
+            temp_scent -= s[y] * this_diffusivity * ( 90 - squares_used ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square.
+            const int new_scent = ( temp_scent + this_diffusivity * ( sum_l[y] + sum_c[y] + sum_r[y] ) ) /
+                                  ( 1000 * 10 );
+            // Cells that block scent don't hold any
+            s[y] = !blocks[y] * new_scent;
+        }
+    }
+
+    // Kept out of the loop above so that it stays branch free
+    for( int x = minx; x <= maxx; ++x ) {
+        for( int y = miny; y <= maxy; ++y ) {
+            if( grscent[x][y] > 10000 ) {
+                dbg( D_ERROR ) << "game:update_scent: Wacky scent at " << x << ","
+                               << y << " (" << grscent[x][y] << ")";
+                debugmsg( "Wacky scent at %d, %d (%d)", x, y, grscent[x][y] );
+                grscent[x][y] = 0; // Scent should never be higher
+            }
+        }
+    }
+}
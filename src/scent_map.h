@@ -0,0 +1,47 @@
+#ifndef SCENT_MAP_H
+#define SCENT_MAP_H
+
+#include "game_constants.h"
+
+/**
+ * Spreads the scent on the scent map (@ref game::grscent) between turns.
+ *
+ * The work is split into separable passes over contiguous columns without
+ * data dependent branches, so that the compiler can vectorize them.
+ * The scratch arrays are kept between turns instead of being put on the stack
+ * for every update. The scent map itself is updated in place: every tile only
+ * reads its own old value, everything it gets from its neighbors is summed up
+ * before the final pass.
+ */
+class scent_diffusion
+{
+    public:
+        /**
+         * Flag caches for the area being updated, filled by @ref map::scent_blockers.
+         * Call @ref clear_blockers before filling them.
+         */
+        /*@{*/
+        bool blocks_scent[SEEX * MAPSIZE][SEEY * MAPSIZE]; // currently only TFLAG_WALL blocks scent
+        bool reduces_scent[SEEX * MAPSIZE][SEEY * MAPSIZE];
+        /*@}*/
+
+        /** Resets the flag caches in the given (inclusive) area. */
+        void clear_blockers( int minx, int miny, int maxx, int maxy );
+
+        /**
+         * Diffuses scent for one turn in the given (inclusive) area.
+         * The flag caches must cover the area plus a one tile border.
+         */
+        void diffuse( int ( &grscent )[SEEX * MAPSIZE][SEEY * MAPSIZE],
+                      int minx, int miny, int maxx, int maxy );
+
+    private:
+        /** How much of a tile's scent takes part in diffusion: 10 if open, 2 if reduced, 0 if blocked. */
+        int weight[SEEX * MAPSIZE][SEEY * MAPSIZE];
+        /** Weighted sum of the scent of the tile and its neighbors in the y direction. */
+        int sum_3_scent_y[SEEX * MAPSIZE][SEEY * MAPSIZE];
+        /** Sum of the weights of the tile and its neighbors in the y direction. */
+        int squares_used_y[SEEX * MAPSIZE][SEEY * MAPSIZE];
+};
+
+#endif
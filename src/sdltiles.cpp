@@ -938,13 +938,13 @@ bool Font::draw_window( WINDOW *win, int offsetx, int offsety )
             const int FG = cell.FG;
             const int BG = cell.BG;
             if( codepoint != UNKNOWN_UNICODE ) {
-                const int cw = utf8_width( cell.ch );
+                const int cw = utf8_width( cell.ch.c_str() );
                 if( cw < 1 ) {
                     // utf8_width() may return a negative width
                     continue;
                 }
                 FillRectDIB( drawx, drawy, fontwidth * cw, fontheight, BG );
-                OutputChar( cell.ch, drawx, drawy, FG );
+                OutputChar( cell.ch.str(), drawx, drawy, FG );
             } else {
                 FillRectDIB( drawx, drawy, fontwidth, fontheight, BG );
                 draw_ascii_lines( static_cast<unsigned char>( cell.ch[0] ), drawx, drawy, FG );
@@ -18,6 +18,9 @@ inline bool sight_check( const float &transparency, const float &/*intensity*/ )
     return transparency > LIGHT_TRANSPARENCY_SOLID;
 }
 
+// castLight doesn't reach tiles further away than this.
+constexpr int SHADOWCASTING_RADIUS = 60;
+
 
 template<int xx, int xy, int yx, int yy,
          float( *calc )( const float &, const float &, const int & ),
@@ -0,0 +1,67 @@
+#include "snapshot.h"
+
+#include <limits>
+
+void content_hash::add( const char *data, const size_t size )
+{
+    static const uint64_t prime = 1099511628211ULL;
+    for( size_t i = 0; i < size; i++ ) {
+        hash ^= static_cast<unsigned char>( data[i] );
+        hash *= prime;
+    }
+}
+
+void content_hash::add( const std::string &str )
+{
+    const uint64_t size = str.size();
+    add( reinterpret_cast<const char *>( &size ), sizeof( size ) );
+    add( str.data(), str.size() );
+}
+
+void snapshot_out::write( const std::string &value )
+{
+    write( static_cast<uint32_t>( value.size() ) );
+    stream.write( value.data(), value.size() );
+}
+
+snapshot_in::snapshot_in( std::istream &stream ) : stream( stream )
+{
+    remaining = std::numeric_limits<uint64_t>::max();
+    const std::istream::pos_type start = stream.tellg();
+    if( start == std::istream::pos_type( -1 ) ) {
+        return;
+    }
+    stream.seekg( 0, std::ios::end );
+    const std::istream::pos_type end = stream.tellg();
+    stream.seekg( start );
+    if( end != std::istream::pos_type( -1 ) && end >= start ) {
+        remaining = end - start;
+    }
+}
+
+void snapshot_in::read_bytes( char *buffer, const size_t size )
+{
+    if( size > remaining || !stream.read( buffer, size ) ) {
+        throw snapshot_error( "unexpected end of the snapshot" );
+    }
+    remaining -= size;
+}
+
+uint32_t snapshot_in::read_size()
+{
+    const uint32_t size = read<uint32_t>();
+    if( size > remaining ) {
+        throw snapshot_error( "invalid size in the snapshot" );
+    }
+    return size;
+}
+
+template<>
+std::string snapshot_in::read<std::string>()
+{
+    std::string value( read_size(), '\0' );
+    if( !value.empty() ) {
+        read_bytes( &value[0], value.size() );
+    }
+    return value;
+}
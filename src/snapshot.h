@@ -0,0 +1,112 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * 64 bit FNV-1a hash of everything added to it. Used to tell whether a snapshot was made
+ * from the same game data, it's not meant to be secure.
+ */
+class content_hash
+{
+    public:
+        void add( const char *data, size_t size );
+        /** Adds the size too, so that "ab" + "c" and "a" + "bc" hash differently. */
+        void add( const std::string &str );
+
+        uint64_t value() const {
+            return hash;
+        }
+
+    private:
+        uint64_t hash = 14695981039346656037ULL;
+};
+
+/** Thrown by @ref snapshot_in when the data is truncated or does not make sense. */
+class snapshot_error : public std::runtime_error
+{
+    public:
+        snapshot_error( const std::string &msg ) : std::runtime_error( msg ) { }
+};
+
+/**
+ * Writes numbers, enums, strings and vectors of them in a compact binary form, to be read
+ * back by @ref snapshot_in. Numbers are stored as they are in memory, so a snapshot can only
+ * be read by the same build on the same machine, which the key of a snapshot should ensure.
+ */
+class snapshot_out
+{
+    public:
+        explicit snapshot_out( std::ostream &stream ) : stream( stream ) { }
+
+        template<typename T>
+        void write( const T &value ) {
+            static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                           "only numbers and enums can be written as they are" );
+            stream.write( reinterpret_cast<const char *>( &value ), sizeof( value ) );
+        }
+        void write( const std::string &value );
+        template<typename T>
+        void write( const std::vector<T> &values ) {
+            write( static_cast<uint32_t>( values.size() ) );
+            for( const T &value : values ) {
+                write( value );
+            }
+        }
+
+    private:
+        std::ostream &stream;
+};
+
+/**
+ * Reads what @ref snapshot_out wrote. The caller must read the same types in the same order.
+ * @throws snapshot_error if the stream ends early.
+ */
+class snapshot_in
+{
+    public:
+        explicit snapshot_in( std::istream &stream );
+
+        template<typename T>
+        T read() {
+            static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                           "only numbers and enums can be read as they are" );
+            char buffer[sizeof( T )];
+            read_bytes( buffer, sizeof( T ) );
+            T value;
+            memcpy( &value, buffer, sizeof( T ) );
+            return value;
+        }
+        template<typename T>
+        std::vector<T> read_vector() {
+            std::vector<T> values( read_size() );
+            for( T &value : values ) {
+                value = read<T>();
+            }
+            return values;
+        }
+        /**
+         * Reads the size of a container. Each element takes at least one byte, so sizes larger
+         * than the rest of the stream are rejected instead of allocating gigabytes.
+         */
+        uint32_t read_size();
+
+    private:
+        void read_bytes( char *buffer, size_t size );
+
+        std::istream &stream;
+        /** Bytes left in the stream. */
+        uint64_t remaining;
+};
+
+template<>
+std::string snapshot_in::read<std::string>();
+
+#endif
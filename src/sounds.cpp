@@ -9,6 +9,7 @@
 #include "translations.h"
 #include "messages.h"
 #include "monster.h"
+#include "creature_tracker.h"
 #include "line.h"
 #include "mtype.h"
 #include "weather.h"
@@ -180,14 +181,10 @@ void sounds::process_sounds()
             overmap_buffer.signal_hordes( target, sig_power );
         }
         // Alert all monsters (that can hear) to the sound.
-        for (int i = 0, numz = g->num_zombies(); i < numz; i++) {
-            monster &critter = g->zombie(i);
-            const int dist = rl_dist( source, critter.pos() );
-            if( vol * 2 > dist ) {
-                // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist );
-            }
-        }
+        // Monsters further than vol * 2 away certainly won't hear the sound.
+        g->critter_tracker->for_each_in_radius( source, vol * 2 - 1, [&source, vol]( monster & critter ) {
+            critter.hear_sound( source, vol, rl_dist( source, critter.pos() ) );
+        } );
     }
     recent_sounds.clear();
 }
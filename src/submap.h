@@ -15,6 +15,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <bitset>
 
 class map;
 class vehicle;
@@ -168,6 +169,24 @@ struct submap {
     active_item_cache active_items;
 
     int field_count = 0;
+    /**
+     * Tiles that may contain fields, indexed by x * SEEY + y. This is a superset: anything
+     * adding fields to a tile must mark it (see @ref mark_field_tile), tiles that don't have
+     * fields anymore are unmarked by field processing.
+     */
+    std::bitset<SEEX * SEEY> field_tiles;
+    void mark_field_tile( const int x, const int y ) {
+        field_tiles.set( x * SEEY + y );
+    }
+    /**
+     * Tiles that may contain items, indexed by x * SEEY + y. A superset like @ref field_tiles:
+     * anything adding items to a tile must mark it (see @ref mark_item_tile), tiles that
+     * don't have items anymore are unmarked by map::tiles_with_items.
+     */
+    std::bitset<SEEX * SEEY> item_tiles;
+    void mark_item_tile( const int x, const int y ) {
+        item_tiles.set( x * SEEY + y );
+    }
     int turn_last_touched = 0;
     int temperature = 0;
     std::vector<spawn_point> spawns;
@@ -247,6 +266,7 @@ public:
         const bool ret = sm->fld[x][y].addField( field_to_add, new_density, new_age );
         if( ret ) {
             sm->field_count++;
+            sm->mark_field_tile( x, y );
         }
 
         return ret;
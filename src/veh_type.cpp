@@ -432,10 +432,15 @@ void vehicle_prototype::finalize()
                 continue;
             }
 
-            if(blueprint.install_part(p.x, p.y, part_id) < 0) {
+            // The caches are refreshed once all parts are installed, refreshing them after
+            // each of the (possibly hundreds of) parts made this quadratic.
+            if( !blueprint.can_mount( p.x, p.y, part_id ) ) {
                 debugmsg("init_vehicles: '%s' part '%s'(%d) can't be installed to %d,%d",
                          blueprint.name.c_str(), part_id.c_str(),
                          blueprint.parts.size(), p.x, p.y);
+            } else {
+                blueprint.install_part( p.x, p.y, vehicle_part( part_id, p.x, p.y,
+                                        item( part_id.obj().item ) ), false );
             }
             if( part_id.obj().has_flag("CARGO") ) {
                 cargo_spots.insert( p );
@@ -461,6 +466,7 @@ void vehicle_prototype::finalize()
         // Clear the parts vector as it is not needed anymore. Usage of swap guaranties that the
         // memory of the vector is really freed (instead of simply marking the vector as empty).
         std::remove_reference<decltype(proto.parts)>::type().swap( proto.parts );
+        blueprint.refresh();
     }
 }
 
@@ -173,15 +173,19 @@ std::list<item>::iterator vehicle_stack::erase( std::list<item>::iterator it )
     return myorigin->remove_item(part_num, it);
 }
 
+std::list<item>::iterator vehicle_stack::erase( std::list<item>::iterator it, item &removed )
+{
+    return myorigin->remove_item( part_num, it, removed );
+}
+
 void vehicle_stack::push_back( const item &newitem )
 {
     myorigin->add_item(part_num, newitem);
 }
 
-void vehicle_stack::insert_at( std::list<item>::iterator index,
-                                   const item &newitem )
+void vehicle_stack::insert_at( std::list<item>::iterator index, item newitem )
 {
-    myorigin->add_item_at(part_num, index, newitem);
+    myorigin->add_item_at( part_num, index, std::move( newitem ) );
 }
 
 std::list<item>::iterator vehicle_stack::begin()
@@ -2157,12 +2161,22 @@ int vehicle::install_part( int dx, int dy, const vpart_str_id &id, item&& obj )
 }
 
 int vehicle::install_part( int dx, int dy, const vehicle_part &new_part )
+{
+    return install_part( dx, dy, new_part, true );
+}
+
+int vehicle::install_part( int dx, int dy, const vehicle_part &new_part, bool refresh_caches )
 {
     parts.push_back( new_part );
     parts.back().mount.x = dx;
     parts.back().mount.y = dy;
-    refresh();
-    return parts.size() - 1;
+    const int p = parts.size() - 1;
+    if( refresh_caches ) {
+        refresh();
+    } else if( part_flag( p, VPFLAG_ENGINE ) ) {
+        engines.push_back( p );
+    }
+    return p;
 }
 
 /**
@@ -5025,8 +5039,8 @@ bool vehicle::add_item_at(int part, std::list<item>::iterator index, item itm)
         itm.contents.clear();
     }
 
-    const auto new_pos = parts[part].items.insert( index, itm );
-    if( itm.needs_processing() ) {
+    const auto new_pos = parts[part].items.insert( index, std::move( itm ) );
+    if( new_pos->needs_processing() ) {
         active_items.add( new_pos, parts[part].mount );
     }
 
@@ -5062,14 +5076,22 @@ bool vehicle::remove_item( int part, const item *it )
 
 std::list<item>::iterator vehicle::remove_item( int part, std::list<item>::iterator it )
 {
-    std::list<item>& veh_items = parts[part].items;
+    item discarded;
+    return remove_item( part, it, discarded );
+}
+
+std::list<item>::iterator vehicle::remove_item( int part, std::list<item>::iterator it,
+                                                item &removed )
+{
+    std::list<item> &veh_items = parts[part].items;
 
     if( active_items.has( it, parts[part].mount ) ) {
         active_items.remove( it, parts[part].mount );
     }
 
     invalidate_mass();
-    return veh_items.erase(it);
+    removed = std::move( *it );
+    return veh_items.erase( it );
 }
 
 vehicle_stack vehicle::get_items(int const part)
@@ -100,8 +100,9 @@ vehicle_stack( std::list<item> *newstack, point newloc, vehicle *neworigin, int
     size_t size() const override;
     bool empty() const override;
     std::list<item>::iterator erase( std::list<item>::iterator it ) override;
+    std::list<item>::iterator erase( std::list<item>::iterator it, item &removed ) override;
     void push_back( const item &newitem ) override;
-    void insert_at( std::list<item>::iterator index, const item &newitem ) override;
+    void insert_at( std::list<item>::iterator index, item newitem ) override;
     std::list<item>::iterator begin();
     std::list<item>::iterator end();
     std::list<item>::const_iterator begin() const;
@@ -317,9 +318,6 @@ private:
     // convert power to epower (watts).
     static int power_to_epower (int power);
 
-    //Refresh all caches and re-locate all parts
-    void refresh();
-
     // Do stuff like clean up blood and produce smoke from broken parts. Returns false if nothing needs doing.
     bool do_environmental_effects();
 
@@ -428,6 +426,14 @@ public:
     int install_part (int dx, int dy, const vpart_str_id &id, int hp = -1, bool force = false);
     // Install a copy of the given part, skips possibility check
     int install_part (int dx, int dy, const vehicle_part &part);
+    /**
+     * Same as above, but with @p refresh_caches false only the engine list is updated (which
+     * @ref can_mount needs). Used to install many parts at once, call @ref refresh when done.
+     */
+    int install_part( int dx, int dy, const vehicle_part &part, bool refresh_caches );
+
+    //Refresh all caches and re-locate all parts
+    void refresh();
 
     /** install item @ref obj to vehicle as a vehicle part */
     int install_part( int dx, int dy, const vpart_str_id& id, item&& obj );
@@ -717,6 +723,8 @@ public:
     bool remove_item( int part, int itemdex );
     bool remove_item( int part, const item *it );
     std::list<item>::iterator remove_item (int part, std::list<item>::iterator it);
+    // Like the above, but moves the item into removed instead of destroying it.
+    std::list<item>::iterator remove_item( int part, std::list<item>::iterator it, item &removed );
 
     vehicle_stack get_items( int part ) const;
     vehicle_stack get_items( int part );
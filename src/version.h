@@ -0,0 +1 @@
+#define VERSION "a93a7ef-dirty"
@@ -15,6 +15,7 @@
 #include "cata_utility.h"
 #include "player.h"
 
+#include <map>
 #include <vector>
 #include <sstream>
 
@@ -58,23 +59,99 @@ void weather_effect::glare()
 
 int get_hourly_rotpoints_at_temp( int temp );
 
+namespace
+{
+
+/**
+ * Running totals of the rot points of one overmap terrain, based on the hourly weather:
+ * totals[i] is the rot accumulated from the start of first_hour to the start of
+ * first_hour + i. The rot between any two turns is the difference of two totals.
+ */
+struct rot_series {
+    int first_hour = 0;
+    std::vector<int> totals;
+    /** Nothing rots here, see @ref get_rot_since. */
+    bool frozen = false;
+};
+
+std::map<tripoint, rot_series> rot_cache;
+/** Seed of the weather the cache has been made with. */
+unsigned rot_cache_seed = 0;
+size_t rot_cache_size = 0;
+
+int rot_points_in_hour( const tripoint &location, int hour )
+{
+    const w_point &w = g->weather_gen->get_hourly_weather( location, calendar( HOURS( hour ) ) );
+    return get_hourly_rotpoints_at_temp( w.temperature );
+}
+
+/** Makes the series cover the hours from first to last (both included). */
+void extend_rot_series( rot_series &series, const tripoint &location, int first, int last )
+{
+    if( series.totals.empty() ) {
+        series.first_hour = first;
+        series.totals.push_back( 0 );
+        rot_cache_size++;
+    }
+    if( first < series.first_hour ) {
+        std::vector<int> totals( 1, 0 );
+        for( int hour = first; hour < series.first_hour; hour++ ) {
+            totals.push_back( totals.back() + rot_points_in_hour( location, hour ) );
+        }
+        const int offset = totals.back();
+        totals.pop_back();
+        rot_cache_size += totals.size();
+        for( const int total : series.totals ) {
+            totals.push_back( total + offset );
+        }
+        series.totals = std::move( totals );
+        series.first_hour = first;
+    }
+    const int covered = series.first_hour + static_cast<int>( series.totals.size() ) - 1;
+    for( int hour = covered; hour < last; hour++ ) {
+        series.totals.push_back( series.totals.back() + rot_points_in_hour( location, hour ) );
+        rot_cache_size++;
+    }
+}
+
+/** Rot accumulated from the start of the series up to turn, which must be covered by it. */
+int rot_until( const rot_series &series, int turn )
+{
+    const int hour = turn / HOURS( 1 );
+    const int index = hour - series.first_hour;
+    const int in_hour = turn - HOURS( hour );
+    const int hour_rot = series.totals[index + 1] - series.totals[index];
+    return series.totals[index] + in_hour * hour_rot / HOURS( 1 );
+}
+
+} // namespace
+
 int get_rot_since( const int startturn, const int endturn, const tripoint &location )
 {
-    // Ensure food doesn't rot in ice labs, where the
-    // temperature is much less than the weather specifies.
+    if( startturn >= endturn ) {
+        return 0;
+    }
+    if( rot_cache_seed != g->weather_gen->get_seed() || rot_cache_size >= max_hourly_cache_size ) {
+        rot_cache.clear();
+        rot_cache_seed = g->weather_gen->get_seed();
+        rot_cache_size = 0;
+    }
     tripoint const omt_pos = ms_to_omt_copy( location );
-    oter_id const & oter = overmap_buffer.ter( omt_pos );
-    // TODO: extract this into a property of the overmap terrain
-    if (is_ot_type("ice_lab", oter)) {
+    const auto inserted = rot_cache.emplace( omt_pos, rot_series() );
+    rot_series &series = inserted.first->second;
+    if( inserted.second ) {
+        // Ensure food doesn't rot in ice labs, where the
+        // temperature is much less than the weather specifies.
+        oter_id const & oter = overmap_buffer.ter( omt_pos );
+        // TODO: extract this into a property of the overmap terrain
+        series.frozen = is_ot_type("ice_lab", oter);
+    }
+    if( series.frozen ) {
         return 0;
     }
     // TODO: maybe have different rotting speed when underground?
-    int ret = 0;
-    for (calendar i(startturn); i.get_turn() < endturn; i += 600) {
-        w_point w = g->weather_gen->get_weather(location, i);
-        ret += std::min(600, endturn - i.get_turn()) * get_hourly_rotpoints_at_temp(w.temperature) / 600;
-    }
-    return ret;
+    extend_rot_series( series, location, startturn / HOURS( 1 ), endturn / HOURS( 1 ) + 1 );
+    return rot_until( series, endturn ) - rot_until( series, startturn );
 }
 
 inline void proc_weather_sum( const weather_type wtype, weather_sum &data,
@@ -124,7 +201,7 @@ weather_sum sum_conditions( const calendar &startturn,
             tick_size = MINUTES(1);
         }
 
-        const auto wtype = g->weather_gen->get_weather_conditions( point( location.x, location.y ), turn );
+        const auto wtype = g->weather_gen->get_hourly_weather_conditions( location, turn );
         proc_weather_sum( wtype, data, turn, tick_size );
     }
 
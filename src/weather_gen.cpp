@@ -3,6 +3,8 @@
 #include "enums.h"
 #include "calendar.h"
 #include "simplexnoise.h"
+#include "coordinate_conversions.h"
+#include "game_constants.h"
 
 #include <cmath>
 #include <fstream>
@@ -103,6 +105,41 @@ weather_type weather_generator::get_weather_conditions( const point &location,
     return wt;
 }
 
+const w_point &weather_generator::get_hourly_weather( const tripoint &location,
+        const calendar &t ) const
+{
+    const point omt = ms_to_omt_copy( point( location.x, location.y ) );
+    const int hour = t.get_turn() / HOURS( 1 );
+    if( hourly_weather_size >= max_hourly_cache_size ) {
+        hourly_weather.clear();
+        hourly_weather_size = 0;
+    }
+    auto &series = hourly_weather[omt];
+    const auto iter = series.find( hour );
+    if( iter != series.end() ) {
+        return iter->second;
+    }
+    hourly_weather_size++;
+    const point corner( omt.x * SEEX * 2, omt.y * SEEY * 2 );
+    return series[hour] = get_weather( corner, calendar( HOURS( hour ) ) );
+}
+
+weather_type weather_generator::get_hourly_weather_conditions( const tripoint &location,
+        const calendar &t ) const
+{
+    if( debug_weather != WEATHER_NULL ) {
+        // Debug mode weather forcing
+        return debug_weather;
+    }
+
+    const weather_type wt = get_weather_conditions( get_hourly_weather( location, t ) );
+    // Make sure we don't say it's sunny at night! =P
+    if( wt == WEATHER_SUNNY && t.is_night() ) {
+        return WEATHER_CLEAR;
+    }
+    return wt;
+}
+
 weather_type weather_generator::get_weather_conditions( const w_point &w ) const
 {
     if( debug_weather != WEATHER_NULL ) {
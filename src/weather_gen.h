@@ -1,8 +1,10 @@
 #ifndef WEATHER_GEN_H
 #define WEATHER_GEN_H
 
-struct point;
-struct tripoint;
+#include "enums.h"
+
+#include <map>
+
 class calendar;
 enum weather_type : int;
 
@@ -14,6 +16,12 @@ struct w_point {
     bool   acidic;
 };
 
+/**
+ * Caches that hold something per hour and place (like the hourly weather) are dropped
+ * beyond this many entries, that's about two years worth of hours for a dozen places.
+ */
+constexpr size_t max_hourly_cache_size = 200000;
+
 class weather_generator
 {
     public:
@@ -28,11 +36,22 @@ class weather_generator
         w_point get_weather( const tripoint &, const calendar & ) const;
         weather_type get_weather_conditions( const point &, const calendar & ) const;
         weather_type get_weather_conditions( const w_point & ) const;
+        /**
+         * Weather at the start of the hour that contains the given turn, taken at the corner
+         * of the overmap terrain that contains the location (absolute map square system).
+         * Results are cached, this is meant for catching up on the weather of long periods
+         * of time (funnels, vehicles), where the precise weather does not matter.
+         */
+        const w_point &get_hourly_weather( const tripoint &, const calendar & ) const;
+        /** Like @ref get_weather_conditions, but uses @ref get_hourly_weather. */
+        weather_type get_hourly_weather_conditions( const tripoint &, const calendar & ) const;
         int get_water_temperature() const;
         void test_weather() const;
 
         void set_seed( unsigned seed ) {
             SEED = seed;
+            hourly_weather.clear();
+            hourly_weather_size = 0;
         }
 
         unsigned get_seed() const {
@@ -45,6 +64,10 @@ class weather_generator
         weather_type debug_weather;
     private:
         unsigned SEED;
+        /** Cache of @ref get_hourly_weather: overmap terrain -> hour -> weather. */
+        mutable std::map<point, std::map<int, w_point>> hourly_weather;
+        /** Number of entries in @ref hourly_weather. */
+        mutable size_t hourly_weather_size = 0;
 };
 
 #endif
@@ -360,7 +360,7 @@ void curses_drawwindow(WINDOW *win)
                         i += cw - 1;
                     }
                     if (tmp) {
-                        const std::wstring utf16 = widen(cell.ch);
+                        const std::wstring utf16 = widen(cell.ch.str());
                         ExtTextOutW( backbuffer, drawx, drawy, 0, NULL, utf16.c_str(), utf16.length(), NULL );
                     }
                 } else {
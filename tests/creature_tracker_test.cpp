@@ -0,0 +1,143 @@
+#include "catch/catch.hpp"
+
+#include "creature_tracker.h"
+#include "game.h"
+#include "line.h"
+#include "monster.h"
+
+#include <vector>
+
+static void clear_creatures()
+{
+    while( g->num_zombies() ) {
+        g->remove_zombie( 0 );
+    }
+}
+
+static void spawn_monsters( const std::vector<tripoint> &positions )
+{
+    for( const tripoint &p : positions ) {
+        monster temp_monster( mtype_id( "mon_zombie" ), p );
+        REQUIRE( g->critter_tracker->add( temp_monster ) );
+    }
+}
+
+static std::vector<tripoint> positions_in_radius( const tripoint &center, int radius )
+{
+    std::vector<tripoint> result;
+    g->critter_tracker->for_each_in_radius( center, radius, [&result]( monster & critter ) {
+        result.push_back( critter.pos() );
+    } );
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+// Brute force version of the query to check the index against.
+static std::vector<tripoint> positions_in_radius_slow( const tripoint &center, int radius )
+{
+    std::vector<tripoint> result;
+    for( size_t i = 0; i < g->num_zombies(); i++ ) {
+        const monster &critter = g->zombie( i );
+        if( !critter.is_dead() && rl_dist( center, critter.pos() ) <= radius ) {
+            result.push_back( critter.pos() );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+TEST_CASE( "creature_tracker_radius_query" )
+{
+    clear_creatures();
+    spawn_monsters( { { 5, 5, 0 }, { 11, 11, 0 }, { 12, 12, 0 }, { 30, 5, 0 }, { 60, 60, 0 }, { 12, 12, 1 } } );
+
+    const tripoint center( 12, 12, 0 );
+    for( int radius : { 0, 1, 6, 7, 20, 100 } ) {
+        INFO( "radius " << radius );
+        CHECK( positions_in_radius( center, radius ) == positions_in_radius_slow( center, radius ) );
+    }
+
+    SECTION( "moving across submap borders" ) {
+        monster &critter = g->zombie( g->mon_at( { 11, 11, 0 } ) );
+        critter.setpos( { 40, 40, 0 } );
+        for( int radius : { 1, 20, 30 } ) {
+            INFO( "radius " << radius );
+            CHECK( positions_in_radius( center, radius ) == positions_in_radius_slow( center, radius ) );
+        }
+    }
+
+    SECTION( "removing monsters" ) {
+        g->remove_zombie( g->mon_at( { 12, 12, 0 } ) );
+        CHECK( positions_in_radius( center, 100 ) == positions_in_radius_slow( center, 100 ) );
+    }
+
+    SECTION( "dead monsters are skipped" ) {
+        g->zombie( g->mon_at( { 5, 5, 0 } ) ).die( nullptr );
+        CHECK( positions_in_radius( center, 100 ) == positions_in_radius_slow( center, 100 ) );
+    }
+    clear_creatures();
+}
+
+TEST_CASE( "creature_tracker_nearest" )
+{
+    clear_creatures();
+    spawn_monsters( { { 20, 20, 0 }, { 26, 20, 0 }, { 40, 20, 0 } } );
+
+    const tripoint center( 24, 20, 0 );
+    const auto any = []( const monster & ) {
+        return true;
+    };
+    const monster *nearest = g->critter_tracker->find_nearest( center, 50, any );
+    REQUIRE( nearest != nullptr );
+    CHECK( nearest->pos() == tripoint( 26, 20, 0 ) );
+
+    const auto not_closest = []( const monster & critter ) {
+        return critter.pos() != tripoint( 26, 20, 0 );
+    };
+    nearest = g->critter_tracker->find_nearest( center, 50, not_closest );
+    REQUIRE( nearest != nullptr );
+    CHECK( nearest->pos() == tripoint( 20, 20, 0 ) );
+
+    CHECK( g->critter_tracker->find_nearest( center, 1, any ) == nullptr );
+    clear_creatures();
+}
+
+TEST_CASE( "creature_tracker_nearest_searches_rings" )
+{
+    clear_creatures();
+    // A monster on each submap, so that find_nearest searches the buckets ring-wise.
+    std::vector<tripoint> positions;
+    for( int x = 0; x < MAPSIZE; x++ ) {
+        for( int y = 0; y < MAPSIZE; y++ ) {
+            if( y != 5 || ( x != 4 && x != 5 ) ) {
+                positions.emplace_back( x * SEEX + 6, y * SEEY + 6, 0 );
+            }
+        }
+    }
+    // As close as the monster on the submap of center, but in the next ring.
+    positions.emplace_back( 61, 60, 0 );
+    positions.emplace_back( 59, 60, 0 );
+    spawn_monsters( positions );
+
+    const tripoint center( 60, 60, 0 );
+    std::vector<tripoint> tried;
+    const auto none = [&tried]( const monster & critter ) {
+        tried.push_back( critter.pos() );
+        return false;
+    };
+    CHECK( g->critter_tracker->find_nearest( center, 6, none ) == nullptr );
+    REQUIRE( tried.size() >= 2 );
+    CHECK( tried[0] == tripoint( 59, 60, 0 ) );
+    CHECK( tried[1] == tripoint( 61, 60, 0 ) );
+    for( size_t i = 1; i < tried.size(); i++ ) {
+        CHECK( rl_dist( center, tried[i - 1] ) <= rl_dist( center, tried[i] ) );
+    }
+
+    const auto any = []( const monster & ) {
+        return true;
+    };
+    const monster *nearest = g->critter_tracker->find_nearest( center, 6, any );
+    REQUIRE( nearest != nullptr );
+    CHECK( nearest->pos() == tripoint( 59, 60, 0 ) );
+    clear_creatures();
+}
@@ -0,0 +1,131 @@
+#include "catch/catch.hpp"
+
+#include "field.h"
+#include "game.h"
+#include "map.h"
+#include "player.h"
+
+#include <vector>
+
+static std::vector<field_id> field_types( const field &fld )
+{
+    std::vector<field_id> result;
+    for( const auto &entry : fld ) {
+        result.push_back( entry.first );
+    }
+    return result;
+}
+
+TEST_CASE( "field_entries_stay_sorted" )
+{
+    field fld;
+    CHECK( fld.addField( fd_smoke, 2 ) );
+    CHECK( fld.addField( fd_blood ) );
+    CHECK( fld.addField( fd_fire ) );
+    CHECK_FALSE( fld.addField( fd_blood, 1 ) );
+    CHECK( fld.fieldCount() == 3 );
+    CHECK( field_types( fld ) == std::vector<field_id>( { fd_blood, fd_fire, fd_smoke } ) );
+    CHECK( fld.findField( fd_blood )->getFieldDensity() == 2 );
+
+    CHECK( fld.upper_bound( fd_blood )->first == fd_fire );
+    CHECK( fld.upper_bound( fd_smoke ) == fld.end() );
+
+    CHECK( fld.removeField( fd_smoke ) );
+    CHECK_FALSE( fld.removeField( fd_smoke ) );
+    CHECK( fld.findField( fd_smoke ) == nullptr );
+    CHECK( field_types( fld ) == std::vector<field_id>( { fd_blood, fd_fire } ) );
+}
+
+TEST_CASE( "field_entry_copy_merges_changes" )
+{
+    field fld;
+    fld.addField( fd_smoke, 1, 10 );
+    {
+        field_entry_copy copy( fld, *fld.findField( fd_smoke ) );
+        copy.get()->setFieldAge( 15 );
+        // Entries added meanwhile must not be lost, even if they move the original.
+        fld.addField( fd_blood );
+        fld.addField( fd_smoke, 1 );
+    }
+    REQUIRE( fld.findField( fd_smoke ) != nullptr );
+    CHECK( fld.findField( fd_smoke )->getFieldAge() == 15 );
+    CHECK( fld.findField( fd_smoke )->getFieldDensity() == 2 );
+    CHECK( fld.findField( fd_blood ) != nullptr );
+
+    {
+        field_entry_copy copy( fld, *fld.findField( fd_smoke ) );
+        copy.get()->setFieldDensity( 0 );
+    }
+    CHECK_FALSE( fld.findField( fd_smoke )->isAlive() );
+}
+
+static void clear_all_fields()
+{
+    const int mapsize = g->m.getmapsize() * SEEX;
+    for( int x = 0; x < mapsize; ++x ) {
+        for( int y = 0; y < mapsize; ++y ) {
+            const tripoint p( x, y, 0 );
+            while( g->m.field_at( p ).fieldCount() > 0 ) {
+                g->m.remove_field( p, g->m.field_at( p ).begin()->first );
+            }
+        }
+    }
+}
+
+TEST_CASE( "opaque_fields_depend_on_density" )
+{
+    field fld;
+    fld.addField( fd_blood, 1, 0 );
+    CHECK( fld.opaque_fields().none() );
+
+    // Thinning smoke stays opaque, but lets more light through.
+    fld.addField( fd_smoke, 3, 0 );
+    const auto thick = fld.opaque_fields();
+    CHECK( thick.test( field_opacity_bit( fd_smoke, 3 ) ) );
+    fld.findField( fd_smoke )->setFieldDensity( 2 );
+    const auto thinner = fld.opaque_fields();
+    CHECK( thinner.test( field_opacity_bit( fd_smoke, 2 ) ) );
+    CHECK( thick != thinner );
+}
+
+TEST_CASE( "field_processing_tracks_transparency" )
+{
+    clear_all_fields();
+    CHECK_FALSE( g->m.process_fields() );
+
+    // Blood doesn't block sight, processing it must not dirty the transparency
+    g->m.add_field( { 40, 40, 0 }, fd_blood, 1, 0 );
+    CHECK_FALSE( g->m.process_fields() );
+
+    // Thick smoke does and goes away eventually
+    g->m.add_field( { 60, 60, 0 }, fd_smoke, 3, 0 );
+    bool changed = false;
+    for( int i = 0; i < 1000 && !changed; i++ ) {
+        changed = g->m.process_fields();
+    }
+    CHECK( changed );
+    clear_all_fields();
+}
+
+TEST_CASE( "adding_transparent_fields_keeps_transparency_cache" )
+{
+    clear_all_fields();
+    const tripoint p( 40, 40, 0 );
+    const auto &dirty = g->m.get_cache_ref( 0 ).transparency_cache_dirty;
+    g->m.build_map_cache( 0 );
+    REQUIRE( dirty.none() );
+
+    g->m.add_field( p, fd_blood, 1, 0 );
+    g->m.add_field( p, fd_blood, 1, 0 );
+    CHECK( dirty.none() );
+
+    g->m.add_field( p, fd_smoke, 3, 0 );
+    CHECK( dirty.any() );
+
+    // Already as thick as it gets, adding more changes nothing
+    g->m.build_map_cache( 0 );
+    REQUIRE( dirty.none() );
+    g->m.add_field( p, fd_smoke, 1, 0 );
+    CHECK( dirty.none() );
+    clear_all_fields();
+}
@@ -0,0 +1,32 @@
+#include "catch/catch.hpp"
+
+#include "item.h"
+#include "item_flag.h"
+#include "itype.h"
+
+TEST_CASE( "flag_ids_are_interned" )
+{
+    const flag_id wet( "WET" );
+    CHECK( wet == flag_id( std::string( "WET" ) ) );
+    CHECK( wet != flag_id( "LITCIG" ) );
+    CHECK( wet.str() == "WET" );
+    CHECK( flag_id( "SOME_FLAG_NOBODY_USES" ).str() == "SOME_FLAG_NOBODY_USES" );
+}
+
+TEST_CASE( "item_flags_come_from_type_and_item" )
+{
+    item towel( "towel_wet", 0 );
+    REQUIRE( towel.type->item_tags.count( "WET" ) > 0 );
+    CHECK( towel.type->has_flag( flag_id( "WET" ) ) );
+    CHECK( towel.has_flag( flag_id( "WET" ) ) );
+    CHECK( towel.has_flag( "WET" ) );
+    CHECK_FALSE( towel.has_flag( flag_id( "SOME_FLAG_NOBODY_USES" ) ) );
+
+    item rock( "rock", 0 );
+    CHECK_FALSE( rock.has_flag( "WET" ) );
+    rock.item_tags.insert( "WET" );
+    CHECK( rock.has_flag( flag_id( "WET" ) ) );
+    CHECK( rock.has_flag( "WET" ) );
+    rock.unset_flags();
+    CHECK_FALSE( rock.has_flag( "WET" ) );
+}
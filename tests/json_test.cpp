@@ -0,0 +1,69 @@
+#include "catch/catch.hpp"
+
+#include "filesystem.h"
+#include "json.h"
+
+#include <istream>
+#include <set>
+#include <sstream>
+#include <string>
+
+TEST_CASE( "json_is_read_in_place_from_memory" )
+{
+    const std::string data =
+        R"([ { "type": "a", "values": [ 1, 2, 3 ], "name": "first" }, { "type": "b", "flag": true } ])";
+    memory_streambuf buffer( data.data(), data.size() );
+    std::istream stream( &buffer );
+    JsonIn jsin( stream );
+
+    JsonArray ja = jsin.get_array();
+    REQUIRE( ja.size() == 2 );
+    JsonObject first = ja.next_object();
+    // Members are looked up by seeking around in the stream.
+    CHECK( first.get_string( "name" ) == "first" );
+    CHECK( first.get_string( "type" ) == "a" );
+    JsonArray values = first.get_array( "values" );
+    CHECK( values.size() == 3 );
+    CHECK( values.get_int( 2 ) == 3 );
+    JsonObject second = ja.next_object();
+    CHECK( second.get_bool( "flag" ) );
+    CHECK_FALSE( ja.has_more() );
+
+    stream.seekg( 0, std::ios::end );
+    CHECK( stream.tellg() == std::streampos( data.size() ) );
+    stream.seekg( 1 );
+    CHECK( stream.peek() == ' ' );
+    stream.seekg( -1, std::ios::cur );
+    CHECK( stream.peek() == '[' );
+    stream.seekg( -1, std::ios::cur );
+    CHECK( stream.fail() );
+}
+
+TEST_CASE( "json_object_member_lookup" )
+{
+    std::istringstream stream(
+        R"({ "b": 2, "//": "first comment", "a": 1, "c": { "x": "y" }, "//": "second comment" })" );
+    JsonIn jsin( stream );
+    JsonObject jo = jsin.get_object();
+
+    CHECK( jo.size() == 4 );
+    CHECK( jo.get_int( "a" ) == 1 );
+    CHECK( jo.get_int( "b" ) == 2 );
+    CHECK( jo.get_object( "c" ).get_string( "x" ) == "y" );
+    // The later of several comments wins.
+    CHECK( jo.get_string( "//" ) == "second comment" );
+    CHECK( jo.get_member_names() == std::set<std::string>( { "a", "b", "c", "//" } ) );
+
+    // Looking up missing members must not add them.
+    CHECK_FALSE( jo.has_member( "d" ) );
+    CHECK( jo.get_int( "d", 4 ) == 4 );
+    CHECK( jo.size() == 4 );
+    CHECK_THROWS_AS( jo.get_int( "d" ), const JsonError & );
+}
+
+TEST_CASE( "json_object_rejects_duplicate_members" )
+{
+    std::istringstream stream( R"({ "a": 1, "b": 2, "a": 3 })" );
+    JsonIn jsin( stream );
+    CHECK_THROWS_AS( jsin.get_object(), const JsonError & );
+}
@@ -0,0 +1,38 @@
+#include "catch/catch.hpp"
+
+#include "game.h"
+#include "item.h"
+#include "map.h"
+#include "map_iterator.h"
+#include "mapdata.h"
+
+#include <vector>
+
+TEST_CASE( "tiles_with_items_skips_empty_tiles" )
+{
+    const int z = g->get_levz();
+    const tripoint center( 60, 60, z );
+    const int radius = 6;
+    for( const tripoint &p : g->m.points_in_radius( center, radius + 1 ) ) {
+        g->m.ter_set( p, t_floor );
+        g->m.furn_set( p, f_null );
+        g->m.i_clear( p );
+    }
+    CHECK( g->m.tiles_with_items( center, radius ).empty() );
+
+    const tripoint first( 58, 56, z );
+    const tripoint second( 62, 56, z );
+    const tripoint outside( 60, 60 + radius + 1, z );
+    g->m.add_item( second, item( "rock", 0 ) );
+    g->m.add_item( first, item( "rock", 0 ) );
+    g->m.add_item( outside, item( "rock", 0 ) );
+    // Same order as points_in_radius.
+    CHECK( g->m.tiles_with_items( center, radius ) == std::vector<tripoint>( { first, second } ) );
+
+    g->m.i_clear( first );
+    CHECK( g->m.tiles_with_items( center, radius ) == std::vector<tripoint>( { second } ) );
+
+    g->m.i_clear( second );
+    g->m.i_clear( outside );
+    CHECK( g->m.tiles_with_items( center, radius ).empty() );
+}
@@ -0,0 +1,192 @@
+#include "catch/catch.hpp"
+
+#include "coordinate_conversions.h"
+#include "filesystem.h"
+#include "game.h"
+#include "item.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "options.h"
+#include "submap.h"
+#include "trap.h"
+#include "worldfactory.h"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+// Far away from anything the tests generate, so the quad files are only written here.
+static const tripoint quad_origin( 1000, 1000, 0 );
+
+static std::string quad_path( const std::string &extension )
+{
+    const tripoint om_addr = sm_to_omt_copy( quad_origin );
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    std::ostringstream path;
+    path << world_generator->active_world->world_path << "/maps/" <<
+         segment_addr.x << "." << segment_addr.y << "." << segment_addr.z << "/" <<
+         om_addr.x << "." << om_addr.y << "." << om_addr.z << extension;
+    return path.str();
+}
+
+static void fill_quad( mapbuffer &buffer )
+{
+    for( int x = 0; x < 2; x++ ) {
+        for( int y = 0; y < 2; y++ ) {
+            std::unique_ptr<submap> sm( new submap() );
+            sm->turn_last_touched = 100 + x + 2 * y;
+            for( int i = 0; i < SEEX; i++ ) {
+                for( int j = 0; j < SEEY; j++ ) {
+                    sm->set_ter( i, j, ter_id( i == j ? "t_floor" : "t_dirt" ) );
+                    sm->set_radiation( i, j, i + j );
+                }
+            }
+            sm->set_furn( 1, 2, furnmap[ "f_chair" ].loadid );
+            sm->set_trap( 3, 4, trap_str_id( "tr_bubblewrap" ).id() );
+            sm->itm[5][6].push_back( item( "rock", 0 ) );
+            REQUIRE( buffer.add_submap( quad_origin + tripoint( x, y, 0 ), sm ) );
+        }
+    }
+}
+
+static void check_quad( mapbuffer &buffer )
+{
+    for( int x = 0; x < 2; x++ ) {
+        for( int y = 0; y < 2; y++ ) {
+            submap *sm = buffer.lookup_submap( quad_origin + tripoint( x, y, 0 ) );
+            REQUIRE( sm != nullptr );
+            CHECK( sm->turn_last_touched == 100 + x + 2 * y );
+            CHECK( sm->get_ter( 0, 0 ) == ter_id( "t_floor" ) );
+            CHECK( sm->get_ter( 0, 1 ) == ter_id( "t_dirt" ) );
+            CHECK( sm->get_radiation( 2, 3 ) == 5 );
+            CHECK( sm->get_furn( 1, 2 ) == furnmap[ "f_chair" ].loadid );
+            CHECK( sm->get_furn( 2, 1 ) == f_null );
+            CHECK( sm->get_trap( 3, 4 ) == trap_str_id( "tr_bubblewrap" ).id() );
+            CHECK( sm->get_trap( 4, 3 ) == tr_null );
+            REQUIRE( sm->itm[5][6].size() == 1 );
+            CHECK( sm->itm[5][6].front().typeId() == "rock" );
+        }
+    }
+}
+
+TEST_CASE( "binary_map_saves_round_trip_and_migrate" )
+{
+    const bool old_option = OPTIONS["BINARY_MAP_SAVES"];
+    const std::string binary_path = quad_path( ".bmap" );
+    const std::string json_path = quad_path( ".map" );
+
+    OPTIONS["BINARY_MAP_SAVES"].setValue( "true" );
+    {
+        mapbuffer buffer;
+        fill_quad( buffer );
+        buffer.save( true );
+        buffer.flush();
+        CHECK( file_exist( binary_path ) );
+        CHECK_FALSE( file_exist( json_path ) );
+        check_quad( buffer );
+
+        // Saving with the option disabled converts the quad back to JSON.
+        OPTIONS["BINARY_MAP_SAVES"].setValue( "false" );
+        buffer.save( true );
+        buffer.flush();
+        CHECK( file_exist( json_path ) );
+        CHECK_FALSE( file_exist( binary_path ) );
+        check_quad( buffer );
+    }
+
+    mapbuffer buffer;
+    check_quad( buffer );
+
+    remove_file( json_path );
+    OPTIONS["BINARY_MAP_SAVES"].setValue( old_option ? "true" : "false" );
+}
+
+TEST_CASE( "broken_binary_map_falls_back_to_json" )
+{
+    const bool old_option = OPTIONS["BINARY_MAP_SAVES"];
+    const std::string binary_path = quad_path( ".bmap" );
+    const std::string json_path = quad_path( ".map" );
+
+    OPTIONS["BINARY_MAP_SAVES"].setValue( "false" );
+    {
+        mapbuffer buffer;
+        fill_quad( buffer );
+        buffer.save( true );
+    }
+    {
+        // A truncated binary file that would otherwise shadow the JSON file.
+        std::ofstream fout( binary_path.c_str(), std::ios::binary );
+        fout << "CDDAQUAD";
+    }
+
+    mapbuffer buffer;
+    check_quad( buffer );
+
+    remove_file( binary_path );
+    remove_file( json_path );
+    OPTIONS["BINARY_MAP_SAVES"].setValue( old_option ? "true" : "false" );
+}
+
+TEST_CASE( "prefetched_and_unwritten_quads_are_loaded" )
+{
+    const bool old_option = OPTIONS["BINARY_MAP_SAVES"];
+    const std::string binary_path = quad_path( ".bmap" );
+
+    OPTIONS["BINARY_MAP_SAVES"].setValue( "true" );
+    mapbuffer buffer;
+    fill_quad( buffer );
+    SECTION( "lookup before the write-behind is done" ) {
+        buffer.save( true );
+        buffer.prefetch( quad_origin );
+        check_quad( buffer );
+    }
+    SECTION( "lookup after prefetching the file" ) {
+        buffer.save( true );
+        buffer.flush();
+        buffer.prefetch( quad_origin );
+        buffer.prefetch( quad_origin + tripoint( 1, 1, 0 ) );
+        check_quad( buffer );
+    }
+    SECTION( "prefetching a missing quad" ) {
+        const tripoint missing = quad_origin + tripoint( 2, 0, 0 );
+        buffer.prefetch( missing );
+        CHECK( buffer.lookup_submap( missing ) == nullptr );
+    }
+    buffer.reset();
+
+    remove_file( binary_path );
+    OPTIONS["BINARY_MAP_SAVES"].setValue( old_option ? "true" : "false" );
+}
+
+TEST_CASE( "quad_io_worker_keeps_the_latest_write" )
+{
+    const std::string path = quad_path( ".test" );
+    const std::string obsolete_path = quad_path( ".test_old" );
+    const tripoint om_addr = sm_to_omt_copy( quad_origin );
+    {
+        std::ofstream fout( obsolete_path.c_str() );
+        fout << "old";
+    }
+
+    quad_io_worker worker;
+    worker.prefetch( om_addr, { path } );
+    for( int i = 0; i < 10; i++ ) {
+        worker.write( om_addr, path, obsolete_path, std::to_string( i ) );
+    }
+    quad_file file;
+    REQUIRE( worker.take( om_addr, file ) );
+    CHECK( file.path == path );
+    CHECK( file.data == "9" );
+
+    worker.flush();
+    CHECK( worker.take_failed_writes().empty() );
+    CHECK_FALSE( file_exist( obsolete_path ) );
+    CHECK_FALSE( worker.take( om_addr, file ) );
+
+    worker.prefetch( om_addr, { obsolete_path, path } );
+    REQUIRE( worker.take( om_addr, file ) );
+    CHECK( file.path == path );
+    CHECK( file.data == "9" );
+
+    remove_file( path );
+}
@@ -0,0 +1,38 @@
+#include "catch/catch.hpp"
+
+#include "mapgen.h"
+
+#include <sstream>
+#include <string>
+
+static std::string mapgen_snapshot( const uint64_t key )
+{
+    std::ostringstream out;
+    write_mapgen_snapshot( out, key );
+    return out.str();
+}
+
+TEST_CASE( "mapgen_snapshot_round_trip" )
+{
+    const uint64_t key = 12345;
+    const std::string snapshot = mapgen_snapshot( key );
+
+    std::istringstream in( snapshot );
+    CHECK( read_mapgen_snapshot( in, key ) );
+    // Restoring must give back exactly what was written.
+    CHECK( mapgen_snapshot( key ) == snapshot );
+}
+
+TEST_CASE( "mapgen_snapshot_rejects_other_data" )
+{
+    const uint64_t key = 12345;
+    const std::string snapshot = mapgen_snapshot( key );
+
+    std::istringstream other_key( snapshot );
+    CHECK_FALSE( read_mapgen_snapshot( other_key, key + 1 ) );
+
+    std::istringstream truncated( snapshot.substr( 0, snapshot.size() / 2 ) );
+    CHECK_FALSE( read_mapgen_snapshot( truncated, key ) );
+    // The functions restored before the data ended are still complete.
+    CHECK( mapgen_snapshot( key ) == snapshot );
+}
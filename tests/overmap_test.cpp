@@ -1,6 +1,11 @@
 #include "catch/catch.hpp"
 
 #include "overmap.h"
+#include "mongroup.h"
+#include "line.h"
+
+#include <algorithm>
+#include <vector>
 
 TEST_CASE( "set_and_get_overmap_scents" ) {
     overmap test_overmap;
@@ -19,3 +24,66 @@ TEST_CASE( "set_and_get_overmap_scents" ) {
     REQUIRE( test_overmap.scent_at( { 75, 85, 0} ).creation_turn == 50 );
     REQUIRE( test_overmap.scent_at( { 75, 85, 0} ).initial_strength == 90 );
 }
+
+static std::vector<tripoint> groups_in_radius( mongroup_grid &grid, const tripoint &center, int radius )
+{
+    std::vector<tripoint> result;
+    grid.for_each_in_radius( center, radius, [&result]( mongroup & group ) {
+        result.push_back( group.pos );
+    } );
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static std::vector<tripoint> groups_in_radius_slow( const mongroup_grid &grid, const tripoint &center, int radius )
+{
+    std::vector<tripoint> result;
+    for( const auto &group : grid ) {
+        if( rl_dist( center, group.pos ) <= radius ) {
+            result.push_back( group.pos );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+TEST_CASE( "mongroup_grid_queries" ) {
+    const mongroup_id type( "GROUP_ZOMBIE" );
+    mongroup_grid grid;
+    const std::vector<tripoint> positions{
+        { 0, 0, 0 }, { 7, 7, 0 }, { 8, 8, 0 }, { 30, 2, 0 }, { -3, -20, 0 }, { 100, 100, 0 }, { 8, 8, 1 }, { 8, 8, 0 }
+    };
+    for( const tripoint &p : positions ) {
+        grid.insert( mongroup( type, p.x, p.y, p.z, 1, 10 ) );
+    }
+    REQUIRE( grid.size() == positions.size() );
+    CHECK( grid.at( { 8, 8, 0 } ).size() == 2 );
+    CHECK( grid.at( { 9, 8, 0 } ).empty() );
+
+    const tripoint center( 8, 8, 0 );
+    for( int radius : { 0, 1, 8, 25, 200 } ) {
+        INFO( "radius " << radius );
+        CHECK( groups_in_radius( grid, center, radius ) == groups_in_radius_slow( grid, center, radius ) );
+    }
+
+    SECTION( "moving keeps the group in place" ) {
+        auto it = grid.begin();
+        const mongroup *address = &*it;
+        grid.move( it, { 50, 50, 0 } );
+        CHECK( &*it == address );
+        CHECK( grid.at( { 0, 0, 0 } ).empty() );
+        REQUIRE( grid.at( { 50, 50, 0 } ).size() == 1 );
+        CHECK( grid.at( { 50, 50, 0 } ).front() == address );
+        CHECK( groups_in_radius( grid, center, 45 ) == groups_in_radius_slow( grid, center, 45 ) );
+    }
+
+    SECTION( "erasing and copying" ) {
+        grid.erase( grid.begin() );
+        CHECK( grid.at( { 0, 0, 0 } ).empty() );
+        mongroup_grid copy( grid );
+        grid.clear();
+        CHECK( copy.size() == positions.size() - 1 );
+        CHECK( copy.at( { 8, 8, 0 } ).size() == 2 );
+        CHECK( groups_in_radius( copy, center, 200 ) == groups_in_radius_slow( copy, center, 200 ) );
+    }
+}
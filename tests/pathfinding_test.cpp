@@ -0,0 +1,127 @@
+#include "catch/catch.hpp"
+
+#include "game.h"
+#include "map.h"
+#include "mapdata.h"
+#include "player.h"
+#include "line.h"
+
+#include <vector>
+
+static void clear_pathfinding_map()
+{
+    const int mapsize = g->m.getmapsize() * SEEX;
+    for( int x = 0; x < mapsize; ++x ) {
+        for( int y = 0; y < mapsize; ++y ) {
+            g->m.set( x, y, t_grass, f_null );
+        }
+    }
+    // Keep the player out of the way
+    g->u.setpos( { 0, 0, -2 } );
+}
+
+static void check_route( const std::vector<tripoint> &route, const tripoint &from, const tripoint &to )
+{
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == to );
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        INFO( "(" << p.x << "," << p.y << "," << p.z << ")" );
+        CHECK( rl_dist( prev, p ) == 1 );
+        CHECK( g->m.passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "long_route_through_wall_gap" )
+{
+    clear_pathfinding_map();
+    const int mapsize = g->m.getmapsize() * SEEX;
+    // A wall across the whole map with a single gap near its bottom end
+    const int wall_x = mapsize / 2;
+    const int gap_y = mapsize - 5;
+    for( int y = 0; y < mapsize; ++y ) {
+        if( y != gap_y ) {
+            g->m.ter_set( wall_x, y, t_rock );
+        }
+    }
+
+    const tripoint from( wall_x - 30, 5, 0 );
+    const tripoint to( wall_x + 30, 5, 0 );
+    const auto route = g->m.route( from, to, 0, 1000 );
+    check_route( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( wall_x, gap_y, 0 ) ) != route.end() );
+}
+
+TEST_CASE( "long_route_on_open_ground" )
+{
+    clear_pathfinding_map();
+    // Scatter some pillars so that a straight line isn't possible
+    for( int x = 20; x < 100; x += 7 ) {
+        g->m.ter_set( x, 30, t_rock );
+    }
+
+    const tripoint from( 10, 30, 0 );
+    const tripoint to( 110, 30, 0 );
+    const auto route = g->m.route( from, to, 0, 1000 );
+    check_route( route, from, to );
+    // Going around the pillars shouldn't take much longer than the straight line
+    CHECK( route.size() <= 120 );
+}
+
+TEST_CASE( "unreachable_long_route" )
+{
+    clear_pathfinding_map();
+    const int mapsize = g->m.getmapsize() * SEEX;
+    const int wall_x = mapsize / 2;
+    for( int y = 0; y < mapsize; ++y ) {
+        g->m.ter_set( wall_x, y, t_rock );
+    }
+
+    const tripoint from( wall_x - 30, 5, 0 );
+    const tripoint to( wall_x + 30, 5, 0 );
+    CHECK( g->m.route( from, to, 0, 1000 ).empty() );
+}
+
+TEST_CASE( "long_route_through_door" )
+{
+    clear_pathfinding_map();
+    const int mapsize = g->m.getmapsize() * SEEX;
+    // A wall with a door on the straight line and a gap far away from it
+    const int wall_x = mapsize / 2;
+    const int door_y = 5;
+    const int gap_y = mapsize - 5;
+    for( int y = 0; y < mapsize; ++y ) {
+        if( y != gap_y ) {
+            g->m.ter_set( wall_x, y, y == door_y ? t_door_c : t_rock );
+        }
+    }
+
+    const tripoint from( wall_x - 30, door_y, 0 );
+    const tripoint to( wall_x + 30, door_y, 0 );
+    const auto route = g->m.route( from, to, 0, 1000 );
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( wall_x, door_y, 0 ) ) != route.end() );
+}
+
+TEST_CASE( "long_route_bashes_instead_of_detour" )
+{
+    clear_pathfinding_map();
+    const int mapsize = g->m.getmapsize() * SEEX;
+    const int wall_x = mapsize / 2;
+    const int gap_y = mapsize - 5;
+    for( int y = 0; y < mapsize; ++y ) {
+        if( y != gap_y ) {
+            g->m.ter_set( wall_x, y, t_wall );
+        }
+    }
+
+    const tripoint from( wall_x - 30, 5, 0 );
+    const tripoint to( wall_x + 30, 5, 0 );
+    const auto route = g->m.route( from, to, 1000, 1000 );
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == to );
+    // Going through the gap would take more than twice as many steps
+    CHECK( route.size() < 100 );
+}
@@ -0,0 +1,85 @@
+#include "catch/catch.hpp"
+
+#include "rng.h"
+
+#include <thread>
+#include <vector>
+
+static std::vector<long> draw( rng_context &ctx, const int count )
+{
+    std::vector<long> result;
+    for( int i = 0; i < count; i++ ) {
+        result.push_back( ctx.rng( -1000, 1000 ) );
+    }
+    return result;
+}
+
+TEST_CASE( "rng_context_is_reproducible" )
+{
+    rng_context a( 42 );
+    rng_context b( 42 );
+    rng_context c( 43 );
+    const std::vector<long> first = draw( a, 100 );
+    CHECK( first == draw( b, 100 ) );
+    CHECK( first != draw( c, 100 ) );
+
+    a.seed( 42 );
+    CHECK( first == draw( a, 100 ) );
+}
+
+TEST_CASE( "rng_stays_in_range" )
+{
+    rng_context ctx( 1 );
+    bool seen_min = false;
+    bool seen_max = false;
+    for( int i = 0; i < 10000; i++ ) {
+        const long val = ctx.rng( 5, -3 );
+        REQUIRE( val >= -3 );
+        REQUIRE( val <= 5 );
+        seen_min = seen_min || val == -3;
+        seen_max = seen_max || val == 5;
+
+        const double d = ctx.next_double();
+        REQUIRE( d >= 0.0 );
+        REQUIRE( d < 1.0 );
+    }
+    CHECK( seen_min );
+    CHECK( seen_max );
+    CHECK_FALSE( ctx.x_in_y( 0, 10 ) );
+    CHECK( ctx.x_in_y( 10, 10 ) );
+    CHECK( ctx.one_in( 1 ) );
+}
+
+TEST_CASE( "rng_context_scope_replaces_the_thread_engine" )
+{
+    rng_context expected( 7 );
+    const std::vector<long> values = draw( expected, 10 );
+
+    rng_context installed( 7 );
+    {
+        rng_context::scope scope( installed );
+        CHECK( &rng_context::current() == &installed );
+        std::vector<long> result;
+        for( int i = 0; i < 10; i++ ) {
+            result.push_back( rng( -1000, 1000 ) );
+        }
+        CHECK( result == values );
+    }
+    CHECK( &rng_context::current() != &installed );
+}
+
+TEST_CASE( "rng_engines_are_per_thread" )
+{
+    rng_set_engine_seed( 3 );
+    rng_context *other = nullptr;
+    std::vector<long> other_values;
+    std::thread worker( [&]() {
+        other = &rng_context::current();
+        rng_context::current().seed( 3 );
+        other_values = draw( rng_context::current(), 10 );
+    } );
+    worker.join();
+
+    CHECK( other != &rng_context::current() );
+    CHECK( draw( rng_context::current(), 10 ) == other_values );
+}
@@ -0,0 +1,112 @@
+#include "catch/catch.hpp"
+
+#include "scent_map.h"
+#include "rng.h"
+
+#include <memory>
+
+typedef int scent_array[SEEX * MAPSIZE][SEEY * MAPSIZE];
+typedef bool flag_array[SEEX * MAPSIZE][SEEY * MAPSIZE];
+
+// The scalar implementation game::update_scent used before scent_diffusion
+static void reference_diffuse( scent_array &grscent, const flag_array &blocks_scent,
+                               const flag_array &reduces_scent,
+                               const int scentmap_minx, const int scentmap_miny,
+                               const int scentmap_maxx, const int scentmap_maxy )
+{
+    std::unique_ptr<scent_array> sum_3_scent_y_ptr( new scent_array[1] );
+    std::unique_ptr<scent_array> squares_used_y_ptr( new scent_array[1] );
+    scent_array &sum_3_scent_y = *sum_3_scent_y_ptr;
+    scent_array &squares_used_y = *squares_used_y_ptr;
+    const int diffusivity = 100;
+
+    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+            sum_3_scent_y[y][x] = 0;
+            squares_used_y[y][x] = 0;
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( ! blocks_scent[x][i] ) {
+                    if( reduces_scent[x][i] ) {
+                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
+                        squares_used_y[y][x] += 2;
+                    } else {
+                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
+                        squares_used_y[y][x] += 10;
+                    }
+                }
+            }
+        }
+    }
+
+    for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
+        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+            if( ! blocks_scent[x][y] ) {
+                int squares_used = squares_used_y[y][x - 1]
+                                   + squares_used_y[y][x]
+                                   + squares_used_y[y][x + 1];
+
+                int this_diffusivity;
+                if( ! reduces_scent[x][y] ) {
+                    this_diffusivity = diffusivity;
+                } else {
+                    this_diffusivity = diffusivity / 5;
+                }
+                int temp_scent;
+                temp_scent = grscent[x][y] * ( 10 * 1000 - squares_used * this_diffusivity );
+                temp_scent -= grscent[x][y] * this_diffusivity * ( 90 - squares_used ) / 5;
+                grscent[x][y] =
+                    ( temp_scent
+                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
+                                             + sum_3_scent_y[y][x]
+                                             + sum_3_scent_y[y][x + 1] )
+                    ) / ( 1000 * 10 );
+            } else {
+                grscent[x][y] = 0;
+            }
+        }
+    }
+}
+
+TEST_CASE( "scent_diffusion_matches_reference" )
+{
+    std::unique_ptr<scent_diffusion> diffuser( new scent_diffusion() );
+    std::unique_ptr<scent_array> expected( new scent_array[1] );
+    std::unique_ptr<scent_array> actual( new scent_array[1] );
+
+    const int minx = 20;
+    const int miny = 25;
+    const int maxx = SEEX * MAPSIZE - 30;
+    const int maxy = SEEY * MAPSIZE - 22;
+
+    for( int pass = 0; pass < 5; ++pass ) {
+        diffuser->clear_blockers( 0, 0, SEEX * MAPSIZE - 1, SEEY * MAPSIZE - 1 );
+        for( int x = 0; x < SEEX * MAPSIZE; ++x ) {
+            for( int y = 0; y < SEEY * MAPSIZE; ++y ) {
+                ( *expected )[x][y] = one_in( 3 ) ? rng( 0, 1000 ) : 0;
+                ( *actual )[x][y] = ( *expected )[x][y];
+                if( one_in( 8 ) ) {
+                    diffuser->blocks_scent[x][y] = true;
+                } else if( one_in( 8 ) ) {
+                    diffuser->reduces_scent[x][y] = true;
+                }
+            }
+        }
+
+        // Run a few turns to let the scent spread over the blocked tiles
+        for( int turn = 0; turn < 10; ++turn ) {
+            reference_diffuse( *expected, diffuser->blocks_scent, diffuser->reduces_scent,
+                               minx, miny, maxx, maxy );
+            diffuser->diffuse( *actual, minx, miny, maxx, maxy );
+        }
+
+        int mismatches = 0;
+        for( int x = 0; x < SEEX * MAPSIZE; ++x ) {
+            for( int y = 0; y < SEEY * MAPSIZE; ++y ) {
+                if( ( *expected )[x][y] != ( *actual )[x][y] ) {
+                    mismatches++;
+                }
+            }
+        }
+        CHECK( mismatches == 0 );
+    }
+}
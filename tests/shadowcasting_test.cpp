@@ -1,7 +1,9 @@
 #include "catch/catch.hpp"
 
+#include "game.h"
 #include "line.h" // For rl_dist.
 #include "map.h"
+#include "mapdata.h"
 #include "shadowcasting.h"
 
 #include <chrono>
@@ -464,3 +466,31 @@ TEST_CASE("shadowcasting_3d_2d_performance", "[.]") {
 TEST_CASE("bresenham_vs_shadowcasting", "[.]") {
     shadowcasting_runoff(1, true);
 }
+
+TEST_CASE("map_sees_follows_the_transparency_cache") {
+    const int z = g->get_levz();
+    const tripoint from( 30, 30, z );
+    const tripoint to( 40, 30, z );
+    const tripoint wall( 35, 30, z );
+    for( int x = 25; x <= 45; x++ ) {
+        for( int y = 25; y <= 35; y++ ) {
+            g->m.ter_set( tripoint( x, y, z ), t_floor );
+            g->m.furn_set( tripoint( x, y, z ), f_null );
+        }
+    }
+    g->m.build_map_cache( z );
+    CHECK( g->m.sees( from, to, -1 ) );
+    CHECK( g->m.sees( from, to, 10 ) );
+    CHECK_FALSE( g->m.sees( from, to, 9 ) );
+
+    g->m.ter_set( wall, t_wall );
+    g->m.build_map_cache( z );
+    CHECK_FALSE( g->m.sees( from, to, -1 ) );
+    // The obstacle itself is visible.
+    CHECK( g->m.sees( from, wall, -1 ) );
+    CHECK( g->m.sees( from, tripoint( 40, 25, z ), -1 ) );
+
+    g->m.ter_set( wall, t_floor );
+    g->m.build_map_cache( z );
+    CHECK( g->m.sees( from, to, -1 ) );
+}
@@ -0,0 +1,63 @@
+#include "catch/catch.hpp"
+
+#include "game.h"
+#include "map.h"
+#include "mapdata.h"
+#include "player.h"
+#include "vehicle.h"
+
+#include <vector>
+
+static void clear_vehicles()
+{
+    for( auto &elem : g->m.get_vehicles() ) {
+        g->m.destroy_vehicle( elem.v );
+    }
+}
+
+static void wipe_map_terrain()
+{
+    const int mapsize = g->m.getmapsize() * SEEX;
+    for( int x = 0; x < mapsize; ++x ) {
+        for( int y = 0; y < mapsize; ++y ) {
+            g->m.set( x, y, t_pavement, f_null );
+        }
+    }
+}
+
+TEST_CASE( "vehmove_moves_every_vehicle_with_velocity" )
+{
+    wipe_map_terrain();
+    clear_vehicles();
+
+    const int z = g->get_levz();
+    const std::vector<int> velocities = { 0, 2000, 4000, 3000 };
+    std::vector<vehicle *> vehicles;
+    std::vector<tripoint> start;
+    for( size_t i = 0; i < velocities.size(); i++ ) {
+        const tripoint pos( 10, 30 + 10 * i, z );
+        vehicle *veh = g->m.add_vehicle( vproto_id( "shopping_cart" ), pos, 0, 0, 0 );
+        REQUIRE( veh != nullptr );
+        veh->velocity = velocities[i];
+        veh->cruise_velocity = velocities[i];
+        vehicles.push_back( veh );
+        start.push_back( veh->global_pos3() );
+    }
+
+    g->m.vehmove();
+
+    CHECK( vehicles[0]->global_pos3() == start[0] );
+    for( size_t i = 1; i < vehicles.size(); i++ ) {
+        CHECK( vehicles[i]->global_pos3() != start[i] );
+        // Everything that could be moved this turn has been moved.
+        CHECK( vehicles[i]->of_turn <= 0 );
+    }
+    CHECK_FALSE( g->m.vehproceed() );
+
+    // Destroyed vehicles must not be moved anymore.
+    g->m.destroy_vehicle( vehicles[2] );
+    g->m.vehmove();
+    CHECK( g->m.get_vehicles().size() == velocities.size() - 1 );
+
+    clear_vehicles();
+}
@@ -57,7 +57,7 @@ TEST_CASE( "visitable_remove", "[visitable]" ) {
     auto tiles = closest_tripoints_first( 1, p.pos() );
     tiles.erase( tiles.begin() ); // player tile
     tripoint veh = random_entry( tiles );
-    REQUIRE( g->m.add_vehicle( vproto_id( "shopping_cart" ), veh, 0 ) );
+    REQUIRE( g->m.add_vehicle( vproto_id( "shopping_cart" ), veh, 0, 0, 0 ) );
 
     item obj = item( liquid_id ).in_its_container();
     REQUIRE( obj.contents.size() == 1 );
@@ -402,6 +402,10 @@ TEST_CASE( "visitable_remove", "[visitable]" ) {
         REQUIRE( part >= 0 );
         part = v->part_with_feature( part, "CARGO" );
         REQUIRE( part >= 0 );
+        // Carts may spawn with some trash in them
+        while( !v->get_items( part ).empty() ) {
+            v->remove_item( part, 0 );
+        }
         for( int i = 0; i != count; ++i ) {
             v->add_item( part, obj );
         }
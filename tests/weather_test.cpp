@@ -0,0 +1,58 @@
+#include "catch/catch.hpp"
+
+#include "calendar.h"
+#include "coordinate_conversions.h"
+#include "game.h"
+#include "map.h"
+#include "player.h"
+#include "weather.h"
+#include "weather_gen.h"
+
+TEST_CASE( "hourly_weather_is_taken_at_the_start_of_the_hour" )
+{
+    weather_generator gen;
+    gen.set_seed( 1234 );
+
+    const tripoint location( 100, 200, 0 );
+    // Corner of the overmap terrain that contains location.
+    const point corner( 96, 192 );
+    for( int hour = 0; hour < 48; hour++ ) {
+        const calendar t( HOURS( hour ) + MINUTES( 25 ) );
+        const w_point expected = gen.get_weather( corner, calendar( HOURS( hour ) ) );
+        const w_point &w = gen.get_hourly_weather( location, t );
+        CHECK( w.temperature == expected.temperature );
+        CHECK( w.humidity == expected.humidity );
+        CHECK( w.pressure == expected.pressure );
+        // The same entry is handed out again.
+        CHECK( &gen.get_hourly_weather( location + tripoint( 5, -3, 0 ), t ) == &w );
+    }
+
+    const w_point before = gen.get_hourly_weather( location, calendar( 0 ) );
+    gen.set_seed( 4321 );
+    const w_point after = gen.get_hourly_weather( location, calendar( 0 ) );
+    CHECK( before.pressure != after.pressure );
+}
+
+TEST_CASE( "hourly_weather_conditions_respect_debug_weather" )
+{
+    weather_generator gen;
+    gen.debug_weather = WEATHER_ACID_RAIN;
+    CHECK( gen.get_hourly_weather_conditions( tripoint( 0, 0, 0 ), calendar( 0 ) ) ==
+           WEATHER_ACID_RAIN );
+}
+
+TEST_CASE( "rot_between_turns_adds_up" )
+{
+    const tripoint omt = ms_to_omt_copy( g->m.getabs( g->u.pos() ) );
+    const tripoint location( omt.x * SEEX * 2, omt.y * SEEY * 2, omt.z );
+    const int start = HOURS( 1000 ) + 123;
+    const int middle = start + HOURS( 30 ) + 77;
+    const int end = middle + DAYS( 10 );
+
+    CHECK( get_rot_since( end, start, location ) == 0 );
+    // Earlier ranges than the cached ones are filled in as well.
+    const int total = get_rot_since( middle, end, location ) + get_rot_since( start, middle,
+                      location );
+    CHECK( get_rot_since( start, end, location ) == total );
+    CHECK( get_rot_since( start, end, location + tripoint( 3, 5, 0 ) ) == total );
+}